@@ -0,0 +1,198 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "asteroid/Audio.hpp"
+#include "asteroid/AudioMixer.hpp"
+#include "../test/TestWav.hpp"
+
+namespace {
+
+constexpr int CHANNELS = 2;
+constexpr int SAMPLE_RATE = 48000;
+// A typical device buffer
+constexpr std::size_t MIX_FRAMES = 512;
+
+std::shared_ptr<const ast::AudioSample> makeSample(std::size_t frameCount, bool int16) {
+    auto sample = std::make_shared<ast::AudioSample>();
+    sample->channels = CHANNELS;
+    sample->frameCount = frameCount;
+    for (std::size_t i = 0; i < frameCount * CHANNELS; ++i) {
+        float value = 0.25f * std::sin(static_cast<float>(i) * 0.01f);
+        if (int16) {
+            sample->data16.push_back(static_cast<std::int16_t>(value * 32767.0f));
+        } else {
+            sample->data.push_back(value);
+        }
+    }
+    return sample;
+}
+
+// Write a one second 16-bit mono WAV at 44.1 kHz, so loading has to resample and
+// change the channel layout as it would for most game assets
+const std::filesystem::path& getTestWav() {
+    static const std::filesystem::path path = [] {
+        auto path = std::filesystem::temp_directory_path() / "asteroid_audio_benchmark.wav";
+        ast::test::writeToneWav(path, 44100);
+        return path;
+    }();
+    return path;
+}
+
+void reportPerSample(benchmark::State& state, std::size_t framesPerIteration) {
+    const double samples =
+        static_cast<double>(state.iterations()) * framesPerIteration * CHANNELS;
+    state.SetItemsProcessed(static_cast<std::int64_t>(samples));
+    // Seconds per output sample, shown with an SI prefix (n for nanoseconds)
+    state.counters["time_per_sample"] =
+        benchmark::Counter(samples, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+}  // namespace
+
+// Args: active voices, 16-bit samples, pitch shifted
+static void BM_MixVoices(benchmark::State& state) {
+    const auto voices = static_cast<std::size_t>(state.range(0));
+    const bool int16 = state.range(1) != 0;
+    const float pitch = state.range(2) != 0 ? 1.5f : 1.0f;
+    ast::AudioMixer mixer(CHANNELS, voices);
+    auto sample = makeSample(SAMPLE_RATE, int16);
+    for (std::size_t i = 0; i < voices; ++i) {
+        ast::AudioMixer::VoiceParams params;
+        params.gain = 0.5f;
+        params.pan = i % 2 == 0 ? -0.5f : 0.5f;
+        params.pitch = pitch;
+        params.loops = 0;
+        mixer.play(static_cast<ast::VoiceId>(i + 1), sample, params);
+    }
+    std::vector<float> out(MIX_FRAMES * CHANNELS);
+
+    for (auto _ : state) {
+        mixer.mix(out.data(), MIX_FRAMES);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    reportPerSample(state, MIX_FRAMES);
+}
+
+// The same mix through Audio's offline backend, including the voice bookkeeping
+static void BM_RenderOffline(benchmark::State& state) {
+    const auto voices = static_cast<std::size_t>(state.range(0));
+    ast::Audio& audio = ast::Audio::getInstance();
+    audio.initOffline(CHANNELS, SAMPLE_RATE);
+    audio.setMaxVoices(voices);
+    audio.loadSound("tone", getTestWav());
+    for (std::size_t i = 0; i < voices; ++i) {
+        audio.playSound("tone", 0);
+    }
+    std::vector<float> out(MIX_FRAMES * CHANNELS);
+
+    for (auto _ : state) {
+        audio.render(out.data(), MIX_FRAMES);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    reportPerSample(state, MIX_FRAMES);
+    audio.shutdown();
+}
+
+// Decoding and converting a WAV to the mix format; arg 1 stores 16-bit samples
+static void BM_LoadSound(benchmark::State& state) {
+    const auto& path = getTestWav();
+    const auto fileSize = static_cast<std::int64_t>(std::filesystem::file_size(path));
+    ast::Audio& audio = ast::Audio::getInstance();
+
+    for (auto _ : state) {
+        // A fresh cache for every load
+        state.PauseTiming();
+        audio.initOffline(CHANNELS, SAMPLE_RATE);
+        audio.setSampleFormat(state.range(0) != 0 ? ast::Audio::SampleFormat::Int16
+                                                  : ast::Audio::SampleFormat::Float32);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(audio.loadSound("tone", path));
+
+        state.PauseTiming();
+        state.counters["resident_bytes"] = static_cast<double>(audio.getStats().residentBytes);
+        audio.shutdown();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * fileSize);
+}
+
+/**
+ * Plays an MP3 stream in real time and periodically stalls for the given number of
+ * milliseconds, after which the missed audio is requested at once, as a device does after
+ * the process was descheduled. Reports how often the decoder could not keep up.
+ * The MP3 is taken from the AST_BENCHMARK_MP3 environment variable.
+ */
+static void BM_StreamHitches(benchmark::State& state) {
+    const char* mp3 = std::getenv("AST_BENCHMARK_MP3");
+    if (!mp3) {
+        state.SkipWithError("Set AST_BENCHMARK_MP3 to an MP3 file to run stream benchmarks");
+        return;
+    }
+    constexpr int FRAMES_PER_SECOND = 60;
+    constexpr int SIMULATED_FRAMES = 2 * FRAMES_PER_SECOND;
+    constexpr int HITCH_INTERVAL = FRAMES_PER_SECOND / 2;
+    const auto hitchFrames = static_cast<std::size_t>(state.range(0) * SAMPLE_RATE / 1000);
+    const std::size_t framesPerFrame = SAMPLE_RATE / FRAMES_PER_SECOND;
+    const auto frameTime = std::chrono::microseconds(1000000 / FRAMES_PER_SECOND);
+
+    ast::Audio& audio = ast::Audio::getInstance();
+    std::vector<float> out(std::max(hitchFrames, framesPerFrame) * CHANNELS);
+    std::uint64_t underruns = 0;
+    int hitches = 0;
+
+    for (auto _ : state) {
+        audio.initOffline(CHANNELS, SAMPLE_RATE);
+        if (!audio.loadStream("music", mp3) || audio.playSound("music", 0) == ast::NULL_VOICE_ID) {
+            state.SkipWithError("Cannot stream AST_BENCHMARK_MP3");
+            audio.shutdown();
+            return;
+        }
+        // Give the decoder thread time to fill the buffer, as the first device callback would
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const std::uint64_t before = audio.getMixerStats().streamUnderruns;
+
+        for (int frame = 1; frame <= SIMULATED_FRAMES; ++frame) {
+            audio.render(out.data(), framesPerFrame);
+            audio.update();
+            if (hitchFrames > 0 && frame % HITCH_INTERVAL == 0) {
+                audio.render(out.data(), hitchFrames);
+                ++hitches;
+            }
+            std::this_thread::sleep_for(frameTime);
+        }
+
+        underruns += audio.getMixerStats().streamUnderruns - before;
+        audio.shutdown();
+    }
+    state.counters["underruns"] =
+        benchmark::Counter(static_cast<double>(underruns), benchmark::Counter::kAvgIterations);
+    state.counters["hitches"] =
+        benchmark::Counter(static_cast<double>(hitches), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_MixVoices)->ArgsProduct({{1, 4, 16, 32, 64}, {0, 1}, {0, 1}});
+BENCHMARK(BM_RenderOffline)->RangeMultiplier(4)->Range(1, 64);
+BENCHMARK(BM_LoadSound)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StreamHitches)
+    ->Arg(0)
+    ->Arg(50)
+    ->Arg(100)
+    ->Arg(250)
+    ->Arg(500)
+    ->Iterations(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "asteroid/JobSystem.hpp"
+
+// Submit a batch of empty jobs and wait for them; the time per job is pure scheduling cost
+static void BM_SubmitAndWait(benchmark::State& state) {
+    ast::JobSystem jobs(static_cast<std::size_t>(state.range(1)));
+    const auto count = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        ast::JobCounter counter;
+        for (int i = 0; i < count; ++i) {
+            jobs.submit([] {}, &counter);
+        }
+        jobs.wait(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["time_per_job"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * count,
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// Jobs spawned from inside a job land on the worker's own deque and are stolen by the others
+static void BM_NestedSubmit(benchmark::State& state) {
+    ast::JobSystem jobs(static_cast<std::size_t>(state.range(1)));
+    const auto count = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        ast::JobCounter outer;
+        jobs.submit(
+            [&jobs, count] {
+                ast::JobCounter inner;
+                for (int i = 0; i < count; ++i) {
+                    jobs.submit([] {}, &inner);
+                }
+                jobs.wait(inner);
+            },
+            &outer);
+        jobs.wait(outer);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// A chain of dependent stages with one job each, measuring the continuation latency
+static void BM_DependencyChain(benchmark::State& state) {
+    ast::JobSystem jobs(static_cast<std::size_t>(state.range(1)));
+    const auto length = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        std::vector<ast::JobCounter> stages(length);
+        jobs.submit([] {}, &stages[0]);
+        for (int i = 1; i < length; ++i) {
+            jobs.submitAfter(stages[i - 1], [] {}, &stages[i]);
+        }
+        jobs.wait(stages.back());
+        for (auto& stage : stages) {
+            jobs.wait(stage);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+static void BM_ParallelFor(benchmark::State& state) {
+    ast::JobSystem jobs(static_cast<std::size_t>(state.range(1)));
+    std::vector<float> values(1 << 20, 1.0f);
+    const auto batchSize = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        jobs.parallelFor(values.size(), batchSize, [&values](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                values[i] = values[i] * 0.5f + 1.0f;
+            }
+        });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(values.size()));
+}
+
+BENCHMARK(BM_SubmitAndWait)->ArgsProduct({{1, 64, 4096}, {0, 1, 3, 7}})->UseRealTime();
+BENCHMARK(BM_NestedSubmit)->ArgsProduct({{64, 4096}, {1, 3, 7}})->UseRealTime();
+BENCHMARK(BM_DependencyChain)->ArgsProduct({{16, 256}, {0, 3}})->UseRealTime();
+BENCHMARK(BM_ParallelFor)->ArgsProduct({{1024, 16384}, {0, 3, 7}})->UseRealTime();
+
+BENCHMARK_MAIN();
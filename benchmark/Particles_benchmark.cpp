@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+
+#include "asteroid/Particles.hpp"
+
+// Particles that outlive the benchmark, so every update is pure integration
+static void BM_UpdateParticles(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    ast::ParticlePool pool(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        pool.spawn({.position = {static_cast<float>(i), 0.0f},
+                    .velocity = {1.0f, static_cast<float>(i % 17)},
+                    .lifetime = 1e9f});
+    }
+    for (auto _ : state) {
+        pool.update(1.0f / 120.0f, {0.0f, 98.0f}, 0.1f);
+        benchmark::DoNotOptimize(pool.getX());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["particles_per_ms"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * count / 1000.0, benchmark::Counter::kIsRate);
+}
+
+// Short-lived particles: each update removes the dead and spawns replacements, as an
+// emitter in steady state does
+static void BM_UpdateWithTurnover(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    ast::ParticlePool pool(count);
+    std::size_t next = 0;
+    auto refill = [&] {
+        while (pool.size() < count) {
+            pool.spawn({.velocity = {1.0f, 1.0f},
+                        .lifetime = 0.05f + static_cast<float>(next++ % 64) * 0.01f});
+        }
+    };
+    refill();
+    for (auto _ : state) {
+        pool.update(1.0f / 120.0f);
+        refill();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["particles_per_ms"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * count / 1000.0, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_UpdateParticles)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_UpdateWithTurnover)->Arg(1000)->Arg(10000)->Arg(100000);
+
+BENCHMARK_MAIN();
@@ -3,10 +3,11 @@
 #include <vector>
 #include <string>
 
-#include "engine/ecs/Registry.hpp"
-#include "engine/ecs/Component.hpp"
-#include "engine/ecs/System.hpp"
-#include "engine/Vector2.hpp"
+#include "asteroid/ecs/Registry.hpp"
+#include "asteroid/ecs/Component.hpp"
+#include "asteroid/ecs/System.hpp"
+#include "asteroid/Texture.hpp"
+#include "asteroid/Vector2.hpp"
 
 // Test components for benchmarking
 namespace benchmark_components {
@@ -45,11 +46,11 @@ struct Transform : ast::Component {
 };
 
 struct Sprite : ast::Component {
-    std::string textureId;
+    ast::TextureId textureId = ast::NULL_TEXTURE_ID;
     bool visible = true;
 
     Sprite() = default;
-    Sprite(const std::string& id) : textureId(id) {}
+    Sprite(ast::TextureId id) : textureId(id) {}
 };
 
 struct AI : ast::Component {
@@ -170,8 +171,8 @@ void addRandomComponents(ast::Registry& registry, const std::vector<ast::Entity>
                 entity, ast::Vector2(posDist(gen), posDist(gen)));
         }
         if (gen() % 5 == 0) {
-            registry.emplace<benchmark_components::Sprite>(entity,
-                                                           "texture_" + std::to_string(gen() % 10));
+            registry.emplace<benchmark_components::Sprite>(
+                entity, static_cast<ast::TextureId>(gen() % 10 + 1));
         }
         if (gen() % 6 == 0) {
             registry.emplace<benchmark_components::AI>(entity, gen() % 4);
@@ -357,7 +358,7 @@ static void BM_SystemQueryPerformance(benchmark::State& state) {
         registry.emplace<benchmark_components::Velocity>(entity, 3.0f, 4.0f);
         registry.emplace<benchmark_components::Health>(entity, 100, 100);
         registry.emplace<benchmark_components::Transform>(entity, ast::Vector2(5.0f, 6.0f));
-        registry.emplace<benchmark_components::Sprite>(entity, "texture_1");
+        registry.emplace<benchmark_components::Sprite>(entity, ast::TextureId{1});
         registry.emplace<benchmark_components::AI>(entity, 0);
     }
 
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include "asteroid/SpriteBatch.hpp"
+
+namespace {
+
+constexpr int TEXTURE_COUNT = 4;
+
+// A software renderer drawing into an offscreen surface, so no display is needed
+struct RenderTarget {
+    RenderTarget() {
+        surface = SDL_CreateSurface(1280, 720, SDL_PIXELFORMAT_RGBA32);
+        renderer = SDL_CreateSoftwareRenderer(surface);
+        for (SDL_Texture*& texture : textures) {
+            texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                                        SDL_TEXTUREACCESS_STATIC, 16, 16);
+        }
+    }
+    ~RenderTarget() {
+        for (SDL_Texture* texture : textures) {
+            SDL_DestroyTexture(texture);
+        }
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroySurface(surface);
+    }
+
+    SDL_FRect destination(int i) const {
+        return {static_cast<float>(i * 37 % 1264), static_cast<float>(i * 53 % 704), 16, 16};
+    }
+
+    SDL_Surface* surface;
+    SDL_Renderer* renderer;
+    SDL_Texture* textures[TEXTURE_COUNT];
+};
+
+}  // namespace
+
+// One SDL_RenderTexture per sprite, the baseline the batch replaces
+static void BM_RenderTexturePerSprite(benchmark::State& state) {
+    RenderTarget target;
+    const auto count = static_cast<int>(state.range(0));
+    const SDL_FRect source{0, 0, 16, 16};
+    for (auto _ : state) {
+        for (int i = 0; i < count; ++i) {
+            const SDL_FRect destination = target.destination(i);
+            SDL_RenderTexture(target.renderer, target.textures[i % TEXTURE_COUNT], &source,
+                              &destination);
+        }
+        SDL_FlushRenderer(target.renderer);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_SpriteBatch(benchmark::State& state) {
+    RenderTarget target;
+    ast::SpriteBatch batch(target.renderer);
+    const auto count = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        for (int i = 0; i < count; ++i) {
+            batch.draw(target.textures[i % TEXTURE_COUNT], {0, 0, 16, 16},
+                       target.destination(i));
+        }
+        batch.flush();
+        SDL_FlushRenderer(target.renderer);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["draw_calls"] = static_cast<double>(batch.getStats().drawCalls);
+}
+
+BENCHMARK(BM_RenderTexturePerSprite)->Arg(1000)->Arg(20000);
+BENCHMARK(BM_SpriteBatch)->Arg(1000)->Arg(20000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+class SDL_IOStream;
+
+namespace ast {
+
+/**
+ * Read-only, memory-mapped archive of asset files.
+ *
+ * File layout (little endian):
+ *   Header
+ *   IndexEntry[entryCount], sorted by nameHash
+ *   name strings, not null terminated
+ *   blobs, each aligned to Header::alignment
+ *
+ * Paths that go through a pack file are resolved transparently, so a pack built from
+ * the assets directory can be used in its place: with assets.pak built from assets/,
+ * the path "assets.pak/images/player.png" reads the entry "images/player.png".
+ * SDL reads asset data in place, through streams that keep the pack mapped until they are
+ * closed.
+ */
+class AssetPack {
+public:
+    static constexpr char MAGIC[4] = {'A', 'S', 'T', 'P'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint32_t ALIGNMENT = 16;
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t entryCount;
+        std::uint32_t alignment;
+        std::uint64_t indexOffset;
+        std::uint64_t namesOffset;
+    };
+
+    struct IndexEntry {
+        std::uint64_t nameHash;  // hashString() of the entry name
+        std::uint64_t offset;
+        std::uint64_t size;
+        std::uint32_t nameOffset;  // Relative to Header::namesOffset
+        std::uint32_t nameLength;
+    };
+
+    static_assert(sizeof(Header) == 32 && sizeof(IndexEntry) == 32);
+
+    /// An asset inside a pack; the data stays valid for as long as pack is held
+    struct Asset {
+        std::shared_ptr<const AssetPack> pack;
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+    };
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+    ~AssetPack();
+
+    /**
+     * Map a pack file. Packs are cached, so opening the same file twice shares the mapping.
+     * @param file The pack file
+     * @return The pack, or nullptr if the file is missing or not a valid pack
+     */
+    static std::shared_ptr<const AssetPack> open(const std::filesystem::path& file);
+
+    /**
+     * Find an asset by a path that goes through a pack file.
+     * @param path A path such as "assets.pak/images/player.png"
+     * @return The asset, or std::nullopt if no parent of path is a pack or the entry is missing
+     */
+    static std::optional<Asset> resolve(const std::filesystem::path& path);
+
+    /**
+     * Open an asset for reading by SDL, from a pack if the path goes through one and from
+     * disk otherwise.
+     * @param path The asset path
+     * @return A stream to be closed by the caller (or by SDL), nullptr on error
+     */
+    static SDL_IOStream* openIO(const std::filesystem::path& path);
+
+    /// Unmap all cached packs that are not in use
+    static void closeAll();
+
+    /**
+     * Build a pack from every regular file below a directory.
+     * @param directory The directory to pack; entry names are relative to it
+     * @param file The pack file to write
+     * @return true on success
+     */
+    static bool write(const std::filesystem::path& directory, const std::filesystem::path& file);
+
+    /**
+     * Look up an entry.
+     * @param name The entry name, relative to the packed directory with '/' separators
+     * @return The entry, or nullptr if not found
+     */
+    const IndexEntry* find(std::string_view name) const;
+
+    const std::uint8_t* getData(const IndexEntry& entry) const { return data_ + entry.offset; }
+    std::string_view getName(const IndexEntry& entry) const;
+    std::size_t getEntryCount() const { return header_->entryCount; }
+    const std::filesystem::path& getPath() const { return path_; }
+
+private:
+    explicit AssetPack(std::filesystem::path path);
+
+    bool map();
+    void unmap();
+
+    std::filesystem::path path_;
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+    const Header* header_ = nullptr;
+    const IndexEntry* index_ = nullptr;
+};
+
+}  // namespace ast
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+namespace ast {
+
+/**
+ * Skyline bottom-left rectangle packer used to place images on atlas pages.
+ * The packer only tracks the upper outline of the placed rectangles, which keeps
+ * insertion cheap at the cost of never reusing space below an overhang.
+ */
+class AtlasPacker {
+public:
+    struct Placement {
+        int x = 0;
+        int y = 0;
+    };
+
+    AtlasPacker(int width, int height);
+
+    /**
+     * Find room for a rectangle and mark it as used.
+     * @param width The width of the rectangle
+     * @param height The height of the rectangle
+     * @return The top-left corner of the rectangle, or std::nullopt if it does not fit
+     */
+    std::optional<Placement> pack(int width, int height);
+
+    /// Forget all placed rectangles
+    void reset();
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+
+    /// Fraction of the page area covered by placed rectangles
+    float getOccupancy() const;
+
+private:
+    struct Segment {
+        int x;
+        int y;
+        int width;
+    };
+
+    // Returns the y coordinate a rectangle would rest at when placed on segment index, or -1
+    int fit(std::size_t index, int width, int height) const;
+
+    std::vector<Segment> skyline_;
+    int width_;
+    int height_;
+    long long usedArea_ = 0;
+};
+
+}  // namespace ast
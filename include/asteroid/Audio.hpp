@@ -2,51 +2,292 @@
 
 #include <SDL3/SDL_audio.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
+
+#include "AudioMixer.hpp"
+#include "SpscRing.hpp"
+#include "StreamingSound.hpp"
 
 namespace ast {
 
+/**
+ * Audio class for loading and playing sounds.
+ * Sounds are converted to the device format when loaded and mixed in software by an
+ * AudioMixer into a single device stream, so a sound can overlap with itself and the
+ * number of simultaneous voices is capped.
+ * Decoded samples are kept in a cache shared by every sound loaded from the same file.
+ * With a memory budget set, samples that no voice is playing are evicted in least
+ * recently used order and decoded again when next played.
+ * WAV and MP3 files are supported. Sounds registered with loadStream() are instead
+ * decoded on a background thread while they play, which suits long MP3 music tracks.
+ * Mixing runs on the SDL audio thread whenever the device needs data, independent of the
+ * frame rate. Calls from the main thread are passed to it through a lock-free queue and
+ * take effect within one device buffer; voice state seen by the main thread, such as
+ * isVoicePlaying(), is refreshed by update().
+ * Without a device, initOffline() lets the caller render the mix into memory instead.
+ */
 class Audio {
 public:
+    using VoiceParams = AudioMixer::VoiceParams;
+
+    enum class SampleFormat {
+        Float32,
+        // Half the memory of Float32 at the cost of a conversion while mixing
+        Int16,
+    };
+
+    /// Gain and pan for one voice, see updateVoices()
+    struct VoiceUpdate {
+        VoiceId voice = NULL_VOICE_ID;
+        float gain = 1.0f;
+        float pan = 0.0f;
+    };
+
+    struct Stats {
+        std::size_t residentBytes = 0;
+        std::size_t budgetBytes = 0;  // 0 means unlimited
+        std::size_t sampleCount = 0;  // Resident samples
+        std::size_t soundCount = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+    };
+
     Audio(const Audio&) = delete;
     Audio& operator=(const Audio&) = delete;
 
     static Audio& getInstance();
 
+    /**
+     * Open the default playback device. For a headless run that still mixes on the audio
+     * thread in real time, set the SDL_AUDIO_DRIVER hint to "dummy" first.
+     * @return true on success
+     */
     bool init();
+
+    /**
+     * Initialize without a device. Nothing is mixed until render() is called, so the
+     * output is deterministic and the cost of mixing can be measured directly.
+     * @param channels The number of output channels
+     * @param sampleRate The output sample rate in Hz
+     * @return true on success
+     */
+    bool initOffline(int channels = 2, int sampleRate = 48000);
     void shutdown();
 
+    /**
+     * Mix the next frames into memory. Only available after initOffline().
+     * @param out Receives frameCount interleaved 32-bit float frames
+     * @param frameCount The number of frames to mix
+     * @return false if audio was not initialized offline
+     */
+    bool render(float* out, std::size_t frameCount);
+    bool isOffline() const { return initialized_ && !device_; }
+    /// Channels of the mix
+    int getChannels() const { return spec_.channels; }
+    /// Sample rate of the mix in Hz
+    int getSampleRate() const { return spec_.freq; }
+
+    /// Load and decode a WAV or MP3 file, or share the sample if the file is already loaded
     bool loadSound(const std::string& name, const std::filesystem::path& filePath);
-    void playSound(const std::string& name, int loops = 1);
+
+    /**
+     * Register an MP3 file to be decoded while it plays instead of when loaded. Only a
+     * small window ahead of playback is kept in memory. Pitch is ignored for streams.
+     * @param name The sound name
+     * @param filePath The MP3 file
+     * @return true if the file exists
+     */
+    bool loadStream(const std::string& name, const std::filesystem::path& filePath);
+
+    /**
+     * Play a sound on a new voice, loading it first if needed.
+     * @param name The sound name
+     * @param loops Number of times to play, 0 to loop until stopped
+     * @return The voice, or NULL_VOICE_ID if the sound could not be played
+     */
+    VoiceId playSound(const std::string& name, int loops = 1);
+    VoiceId playSound(const std::string& name, const VoiceParams& params);
+    /// Stop every voice playing the sound
     void stopSound(const std::string& name);
+    void stopVoice(VoiceId voice);
+    void stopAll();
 
     float getMasterGain() const;
     void setMasterGain(float gain);
     float getSoundGain(const std::string& name) const;
+    /// Set the gain of a sound; applies to voices started or given a new gain afterwards
     void setSoundGain(const std::string& name, float gain);
+    /// Set the gain of a voice, relative to the gain of its sound
+    void setVoiceGain(VoiceId voice, float gain);
+    void setVoicePitch(VoiceId voice, float pitch);
+    void setVoicePan(VoiceId voice, float pan);
+
+    /**
+     * Set the gain and pan of many voices with a single write to the command queue.
+     * The whole batch takes effect in the same audio callback. Gains are relative to the
+     * gain of each voice's sound, as in playSound().
+     * @param updates The new voice parameters
+     */
+    void updateVoices(const std::vector<VoiceUpdate>& updates);
     bool isSoundPlaying(const std::string& name) const;
+    bool isVoicePlaying(VoiceId voice) const;
     void setAssetsDirectory(const std::filesystem::path& directory);
 
+    /**
+     * Set the maximum number of simultaneous voices. When every voice is busy, playing
+     * a sound replaces the lowest priority voice.
+     * @param maxVoices The number of voices, at most AudioMixer::MAX_VOICES
+     */
+    void setMaxVoices(std::size_t maxVoices);
+    AudioMixer::Stats getMixerStats() const;
+
+    /**
+     * Limit the memory used by decoded samples. Samples that are not playing and were not
+     * used in the current frame are evicted in least recently used order.
+     * @param bytes The budget in bytes, 0 for unlimited
+     */
+    void setMemoryBudget(std::size_t bytes);
+
+    /**
+     * Choose how samples are stored. Only affects samples loaded afterwards.
+     * @param format The storage format
+     */
+    void setSampleFormat(SampleFormat format);
+
+    Stats getStats() const;
+
+    /**
+     * Set the size of the device buffer, which bounds the delay between playing a sound
+     * and hearing it. Smaller values risk underruns on slow machines.
+     * Takes effect on the next init().
+     * @param seconds The target latency
+     */
+    void setTargetLatency(double seconds);
+    /// The latency of the opened device buffer in seconds
+    double getLatency() const;
+
+    /// Collect voices that have ended on the audio thread and enforce the memory budget.
+    /// Called once per frame.
     void update();
 
 private:
     Audio() = default;
 
-    struct AudioData {
-        SDL_AudioSpec spec;
-        Uint8* buffer = nullptr;
-        SDL_AudioStream* stream = nullptr;
-        Uint32 length = 0;
-        Uint32 currentPosition = 0;
+    struct Sound {
+        std::filesystem::path path;
+        float gain = 1.0f;
+        bool streamed = false;
+    };
+
+    struct CachedSample {
+        // Also held by the voices playing it; evictable when the cache holds the only reference
+        std::shared_ptr<const AudioSample> sample;
+        std::size_t bytes = 0;
+        std::uint64_t lastUsedFrame = 0;
+    };
+
+    struct Command {
+        enum class Type {
+            Play,
+            PlayStream,
+            Stop,
+            StopSource,
+            StopAll,
+            SetGain,
+            SetPan,
+            SetGainAndPan,
+            SetPitch,
+            SetMaxVoices,
+        };
+
+        Type type = Type::Stop;
+        VoiceId voice = NULL_VOICE_ID;
+        const void* source = nullptr;
+        float value = 0.0f;
+        float pan = 0.0f;
+        std::size_t count = 0;
+        VoiceParams params;
+        std::shared_ptr<const AudioSample> sample;
+        std::shared_ptr<StreamingSound> stream;
     };
 
-    std::unordered_map<std::string, AudioData> sounds_;
-    std::unordered_map<std::string, int> playing_;
+    static constexpr std::size_t COMMAND_QUEUE_SIZE = 4096;
+    // Every voice ending in one callback was either playing before it or started by one of
+    // its commands
+    static constexpr std::size_t ENDED_QUEUE_SIZE = COMMAND_QUEUE_SIZE + AudioMixer::MAX_VOICES;
+
+    // Set up the mixer and the decoder thread for the given output format
+    void start(int channels, int sampleRate);
+    // Forget voices the mixer has reported as ended; only without a device
+    void collectEndedVoices();
+    // Pass the mixer's ended voices to the main thread; audio thread only
+    void forwardEndedVoices();
+    // Rebuild voices_ from the mixer after ended voices were lost to a full queue
+    void resyncVoices();
+    // The gain of the sound a voice plays, which scales every gain set on the voice
+    float getVoiceSoundGain(VoiceId voice) const;
+
+    // Get a cached sample, decoding it on a miss
+    std::shared_ptr<const AudioSample> acquireSample(const std::filesystem::path& filePath);
+    std::shared_ptr<AudioSample> decodeSample(const std::filesystem::path& filePath) const;
+    void evictToBudget();
+    static void SDLCALL feedStream(void* userdata, SDL_AudioStream* stream, int additionalAmount,
+                                   int totalAmount);
+    // Pass a command to the audio thread, or apply it directly if there is no device
+    bool submit(Command command);
+    void execute(Command& command);
+    void decoderLoop();
+
+    // Sound addresses identify their voices in the mixer
+    std::unordered_map<std::string, Sound> sounds_;
+    // Keyed by file path
+    std::unordered_map<std::string, CachedSample> samples_;
     std::filesystem::path assetsDirectory_;
+    SampleFormat sampleFormat_ = SampleFormat::Float32;
+    std::size_t memoryBudget_ = 0;
+    std::size_t residentBytes_ = 0;
+    std::uint64_t frame_ = 0;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+    std::uint64_t evictions_ = 0;
     SDL_AudioDeviceID device_ = 0;
+    // Format of the samples and the mix: 32-bit float in the device layout
+    SDL_AudioSpec spec_{};
+    SDL_AudioStream* stream_ = nullptr;
+    double targetLatency_ = 0.02;
+    float offlineGain_ = 1.0f;  // Master gain without a device
+    int deviceFrames_ = 0;
     bool initialized_ = false;
+
+    // Owned by the audio thread while the device is open
+    AudioMixer mixer_;
+    std::vector<float> mixBuffer_;
+
+    // Main thread -> audio thread
+    SpscRing<Command> commands_{COMMAND_QUEUE_SIZE};
+    std::vector<Command> batch_;
+    // Audio thread -> main thread
+    SpscRing<VoiceId> endedVoices_{ENDED_QUEUE_SIZE};
+    std::atomic<bool> endedVoicesLost_{false};
+    // Voices the main thread believes are playing, by source
+    std::unordered_map<VoiceId, const void*> voices_;
+    VoiceId nextVoiceId_ = 1;
+
+    // Streams being decoded; the decoder thread drops a stream once no voice holds it
+    std::thread decoderThread_;
+    std::mutex streamsMutex_;
+    std::condition_variable streamsChanged_;
+    std::vector<std::shared_ptr<StreamingSound>> streams_;
+    bool stopDecoder_ = false;
 };
 
-}  // namespace ast
\ No newline at end of file
+}  // namespace ast
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace ast {
+
+class StreamingSound;
+
+/// Identifies a playing voice; ids are never reused
+using VoiceId = std::uint32_t;
+
+inline constexpr VoiceId NULL_VOICE_ID = 0;
+
+/**
+ * Interleaved PCM in the mixer's channel layout and sample rate, stored either as
+ * 32-bit float or as 16-bit integers to halve its memory.
+ */
+struct AudioSample {
+    std::vector<float> data;
+    std::vector<std::int16_t> data16;  // Used instead of data for 16-bit storage
+    int channels = 0;
+    std::size_t frameCount = 0;
+
+    std::size_t getByteSize() const {
+        return data.size() * sizeof(float) + data16.size() * sizeof(std::int16_t);
+    }
+};
+
+/**
+ * Software mixer with a fixed pool of voices. The pool is allocated for MAX_VOICES up front,
+ * so changing the voice limit never allocates.
+ * Voices reference shared samples, so one sound can play on any number of voices
+ * without copying its data. When every voice is busy, a new voice replaces the
+ * lowest priority one (the oldest among equals) unless all playing voices have a
+ * higher priority than the new one.
+ * Streamed sounds are played by voices that read from a StreamingSound instead.
+ */
+class AudioMixer {
+public:
+    struct VoiceParams {
+        float gain = 1.0f;
+        // -1 is left, 1 is right; attenuates the opposite channel of stereo output
+        float pan = 0.0f;
+        // Playback rate; 2.0 plays an octave higher and twice as fast. Ignored for streams.
+        float pitch = 1.0f;
+        int priority = 0;
+        // Number of times to play, 0 to loop until stopped
+        int loops = 1;
+    };
+
+    struct Stats {
+        std::size_t activeVoices = 0;
+        std::size_t maxVoices = 0;
+        std::uint64_t stolenVoices = 0;
+        std::uint64_t rejectedVoices = 0;
+        // Mixes in which a streamed voice had fewer frames decoded than it needed
+        std::uint64_t streamUnderruns = 0;
+    };
+
+    /// Upper bound for setMaxVoices()
+    static constexpr std::size_t MAX_VOICES = 256;
+    /// Frames read from a stream at a time; mixing at most this many per call is cheapest
+    static constexpr std::size_t MIX_FRAMES = 512;
+
+    AudioMixer(int channels = 2, std::size_t maxVoices = 32);
+
+    /**
+     * Start a voice.
+     * @param id The id of the new voice, chosen by the caller
+     * @param sample The sample to play; must have the mixer's channel count
+     * @param params The voice parameters
+     * @param source Identifies the voice in stop() and isPlaying(); defaults to the sample
+     * @return false if no voice was free and none could be stolen
+     */
+    bool play(VoiceId id, std::shared_ptr<const AudioSample> sample, const VoiceParams& params,
+              const void* source = nullptr);
+
+    /**
+     * Start a voice that plays a stream until it ends. Loops are handled by the stream.
+     * @param id The id of the new voice, chosen by the caller
+     * @param stream The stream to read from; must be in the mixer's channel layout
+     * @param params The voice parameters
+     * @param source Identifies the voice in stop() and isPlaying()
+     * @return false if no voice was free and none could be stolen
+     */
+    bool play(VoiceId id, std::shared_ptr<StreamingSound> stream, const VoiceParams& params,
+              const void* source);
+
+    void stop(VoiceId id);
+    /// Stop every voice started with a source
+    void stop(const void* source);
+    void stopAll();
+
+    void setGain(VoiceId id, float gain);
+    void setPan(VoiceId id, float pan);
+    void setPitch(VoiceId id, float pitch);
+    bool isPlaying(VoiceId id) const;
+    bool isPlaying(const void* source) const;
+
+    /**
+     * Mix all voices and advance them.
+     * @param out Receives frameCount interleaved frames; overwritten, not accumulated
+     * @param frameCount The number of frames to mix
+     */
+    void mix(float* out, std::size_t frameCount);
+
+    /**
+     * Change the number of usable voices. Voices beyond the new limit are stopped.
+     * @param maxVoices The number of voices, clamped to MAX_VOICES
+     */
+    void setMaxVoices(std::size_t maxVoices);
+
+    /**
+     * Voices that ended or were stopped, stolen or rejected since the last clearEndedVoices().
+     * Room for MAX_VOICES ids is reserved; clear after every mix() and every call that can
+     * end voices to keep the list from allocating.
+     */
+    const std::vector<VoiceId>& getEndedVoices() const { return endedVoices_; }
+    void clearEndedVoices() { endedVoices_.clear(); }
+
+    int getChannels() const { return channels_; }
+    std::size_t getActiveVoiceCount() const { return activeCount_; }
+    Stats getStats() const;
+
+private:
+    struct Voice {
+        VoiceId id = NULL_VOICE_ID;  // NULL_VOICE_ID while the voice is free
+        std::shared_ptr<const AudioSample> sample;
+        std::shared_ptr<StreamingSound> stream;  // Set instead of sample for streamed voices
+        const void* source = nullptr;
+        double position = 0.0;  // In frames
+        float gain = 1.0f;
+        float pan = 0.0f;
+        float pitch = 1.0f;
+        int priority = 0;
+        int loops = 1;
+        std::uint64_t startOrder = 0;
+    };
+
+    // The slots below the voice limit; the ones above it are always free
+    std::span<Voice> getSlots() { return {voices_.data(), maxVoices_}; }
+    std::span<const Voice> getSlots() const { return {voices_.data(), maxVoices_}; }
+    Voice* find(VoiceId id);
+    const Voice* find(VoiceId id) const;
+    Voice* allocate(int priority, VoiceId id, const VoiceParams& params, const void* source);
+    void release(Voice& voice);
+    template <typename T>
+    void mixVoice(Voice& voice, const T* src, float* out, std::size_t frameCount);
+    void mixStream(Voice& voice, float* out, std::size_t frameCount);
+
+    std::vector<Voice> voices_;  // Always MAX_VOICES long
+    std::vector<float> streamBuffer_;  // Always MIX_FRAMES frames long
+    std::vector<VoiceId> endedVoices_;
+    int channels_;
+    std::size_t maxVoices_;
+    std::size_t activeCount_ = 0;
+    std::uint64_t nextStartOrder_ = 0;
+    std::uint64_t stolenVoices_ = 0;
+    std::uint64_t rejectedVoices_ = 0;
+    std::uint64_t streamUnderruns_ = 0;
+};
+
+}  // namespace ast
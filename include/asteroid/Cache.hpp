@@ -1,43 +1,345 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
+#include "AtlasPacker.hpp"
 #include "Color.hpp"
+#include "Hash.hpp"
 #include "Texture.hpp"
 
 class SDL_Renderer;
+class SDL_Surface;
 
 namespace ast {
+
+class TextureHandle;
+
 /**
  * Cache class for managing textures and dummy textures.
  * This class is a singleton that provides access to textures by file name
  * and allows for the creation of dummy textures based on color.
+ * Textures can also be requested asynchronously: images are decoded on worker
+ * threads and uploaded on the render thread by update().
+ * When atlas packing is enabled, small images are packed into shared pages and
+ * Texture::source locates the image on its page.
+ * With a memory budget set, update() evicts the least recently used textures that
+ * are not held by a TextureHandle. Atlas pages are evicted as a whole once none of their
+ * images is in use, and reloaded images go back to their old slot. References returned
+ * by getTexture() are only guaranteed to stay valid until the next update().
+ * Every file name is assigned a TextureId on first use. Ids index a dense table and stay
+ * valid across eviction and clear(); a released texture is reloaded when next accessed.
+ * Resolve ids once and use them for per-frame lookups instead of file names.
+ * getTextureId() and findTextureId() may be called from any thread, e.g. from a pipelined
+ * simulation; everything else must be called on the render thread.
  */
 class Cache {
 public:
+    using PreloadCallback = std::function<void()>;
+
+    struct AtlasOptions {
+        bool enabled = false;
+        int pageSize = 2048;
+        // Images larger than this in either dimension get a standalone texture
+        int maxImageSize = 256;
+        // Transparent border around each image to avoid bleeding when filtering
+        int padding = 1;
+    };
+
+    struct Stats {
+        std::size_t residentBytes = 0;
+        std::size_t budgetBytes = 0;  // 0 means unlimited
+        std::size_t textureCount = 0;
+        std::size_t atlasPageCount = 0;
+        std::size_t dummyTextureCount = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+    };
+
     Cache(const Cache&) = delete;
     Cache& operator=(const Cache&) = delete;
 
     static Cache& getInstance();
+    /// Create textures with a renderer; a null renderer, as in headless mode, creates none
+    /// and starts no decode workers
     static void init(SDL_Renderer* renderer);
+    static void shutdown();
     static const Texture& getTexture(const std::string& fileName);
+    static const Texture& getTexture(TextureId id);
+    /// Get a 1x1 texture of the given color. Created once per color and owned by the cache.
     static Texture getDummyTexture(const ast::Color& color);
     static void setAssetsDirectory(const std::filesystem::path& directory);
     static void clear();
 
+    /**
+     * Get the id for a file name without loading the texture.
+     * @param fileName The image file, relative to the assets directory
+     * @return The id, assigned on first use
+     */
+    static TextureId getTextureId(std::string_view fileName);
+
+    /**
+     * Look up the id of a file name by its hashString() value, which can be computed at
+     * compile time for literal names.
+     * @param nameHash The hash of the file name
+     * @return The id, or NULL_TEXTURE_ID if the name has not been seen by the cache yet.
+     *         If several names share the hash, the first one resolved wins; use
+     *         getTextureId() when that matters.
+     */
+    static TextureId findTextureId(std::uint64_t nameHash);
+
+    /**
+     * Load a texture and return its id.
+     * @param fileName The image file, relative to the assets directory
+     * @return The id; getTexture() returns MISSING_TEXTURE for it if loading failed
+     */
+    static TextureId loadTexture(std::string_view fileName);
+
+    /**
+     * Load a texture and keep it resident for as long as the handle lives.
+     * @param id The texture id
+     * @return A handle to the texture; an empty handle if loading failed
+     */
+    static TextureHandle acquireTexture(TextureId id);
+    static TextureHandle acquireTexture(const std::string& fileName);
+
+    /**
+     * Request a texture without blocking on disk access or image decoding.
+     * @param fileName The image file, relative to the assets directory
+     * @param placeholder Returned until the texture has been uploaded
+     * @return The texture if it is resident, otherwise the placeholder
+     */
+    static const Texture& requestTexture(const std::string& fileName,
+                                         const Texture& placeholder = MISSING_TEXTURE);
+    static const Texture& requestTexture(TextureId id,
+                                         const Texture& placeholder = MISSING_TEXTURE);
+
+    /**
+     * Request a list of textures, e.g. for a loading screen.
+     * @param fileNames The image files, relative to the assets directory
+     * @param onComplete Invoked from update() once every texture is loaded or has failed
+     */
+    static void preload(const std::vector<std::string>& fileNames,
+                        PreloadCallback onComplete = {});
+
+    /**
+     * Upload decoded images to the renderer and enforce the memory budget.
+     * Must be called once per frame on the render thread.
+     * @param budgetSec Time budget for uploads; at least one image is uploaded per call
+     */
+    static void update(double budgetSec = 0.002);
+
+    /// Number of requested textures that are not resident yet
+    static std::size_t getPendingCount();
+
+    /**
+     * Limit the memory used by textures. Unreferenced textures that were not used in the
+     * current or previous frame are evicted in least recently used order.
+     * @param bytes The budget in bytes, 0 for unlimited
+     */
+    static void setMemoryBudget(std::size_t bytes);
+
+    static Stats getStats();
+
+    /**
+     * Configure atlas packing. Only affects images loaded afterwards.
+     * @param options The atlas options
+     */
+    static void setAtlasOptions(const AtlasOptions& options);
+
+    /**
+     * Write the placement of every packed image to a JSON file.
+     * @param path The file to write
+     * @return true on success
+     */
+    static bool saveAtlasLayout(const std::filesystem::path& path);
+
+    /**
+     * Read placements written by saveAtlasLayout(). Images listed in the layout are placed
+     * at their recorded position instead of being packed, which keeps pages identical
+     * across runs regardless of load order. Must be called before any image is packed.
+     * @param path The file to read
+     * @return true on success
+     */
+    static bool loadAtlasLayout(const std::filesystem::path& path);
+
     inline static Texture MISSING_TEXTURE{};
 
 private:
+    friend class TextureHandle;
+
+    static constexpr std::size_t NO_PAGE = std::numeric_limits<std::size_t>::max();
+
     Cache() = default;
+    ~Cache();
+
+    struct Entry {
+        std::string fileName;
+        Texture texture;  // handle is null while the texture is not resident
+        std::size_t bytes = 0;
+        std::size_t page = NO_PAGE;
+        unsigned refCount = 0;
+        std::uint64_t lastUsedFrame = 0;
+        bool failed = false;
+    };
+
+    struct DecodeRequest {
+        TextureId id = NULL_TEXTURE_ID;
+        std::filesystem::path path;
+    };
+
+    struct DecodeResult {
+        TextureId id = NULL_TEXTURE_ID;
+        SDL_Surface* surface = nullptr;
+        unsigned generation = 0;
+    };
 
-    const Texture& getTextureImpl(const std::string& fileName);
+    struct PreloadGroup {
+        std::size_t remaining = 0;
+        PreloadCallback onComplete;
+    };
+
+    struct AtlasPage {
+        SDL_Texture* handle = nullptr;  // Created on first use
+        AtlasPacker packer;
+        std::size_t liveCount = 0;
+    };
+
+    struct AtlasPlacement {
+        std::size_t page = 0;
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    TextureId resolve(std::string_view fileName);
+    Entry* findResident(TextureId id);
+    const Texture& getTextureImpl(TextureId id);
     Texture getDummyTextureImpl(const ast::Color& color);
+    void destroyDummyTextures();
+    const Texture& requestTextureImpl(TextureId id, const Texture& placeholder);
+    void preloadImpl(const std::vector<std::string>& fileNames, PreloadCallback onComplete);
+    void updateImpl(double budgetSec);
+    const Texture& addTexture(TextureId id, SDL_Surface* surface);
+    std::optional<Texture> packTexture(const std::string& fileName, SDL_Surface* surface,
+                                       std::size_t& pageIndex);
+    SDL_Texture* getAtlasPage(std::size_t index);
+    void releaseTexture(Entry& entry);
+    void evictToBudget();
+    void enqueueDecode(TextureId id);
+    void uploadDecoded(DecodeResult& result);
+    void finishRequest(TextureId id);
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop();
+
+    /**
+     * Append-only id -> entry table. Entries live in chunks that never move, so references
+     * returned by getTexture() stay valid and the render thread can read entries by id
+     * while another thread appends; appends are serialized by idsMutex_.
+     */
+    class EntryTable {
+    public:
+        EntryTable() { append(Entry{}); }  // Slot 0 is NULL_TEXTURE_ID
+
+        std::size_t size() const { return size_.load(std::memory_order_acquire); }
+        Entry& operator[](std::size_t id) { return chunks_[id / CHUNK_SIZE][id % CHUNK_SIZE]; }
+        const Entry& operator[](std::size_t id) const {
+            return chunks_[id / CHUNK_SIZE][id % CHUNK_SIZE];
+        }
+
+        /// @return The id of the new entry, or NULL_TEXTURE_ID if the table is full
+        TextureId append(Entry entry);
 
-    std::unordered_map<std::string, Texture> textures_;
+    private:
+        static constexpr std::size_t CHUNK_SIZE = 1024;
+        static constexpr std::size_t MAX_CHUNKS = 1024;
+
+        std::array<std::unique_ptr<Entry[]>, MAX_CHUNKS> chunks_;
+        std::atomic<std::size_t> size_ = 0;
+    };
+
+    EntryTable entries_;
+    // Name hash -> id; a multimap because distinct names may share a hash
+    std::unordered_multimap<std::uint64_t, TextureId> ids_;
+    std::mutex idsMutex_;
+    std::unordered_map<std::uint32_t, Texture> dummyTextures_;
     std::filesystem::path assetsDirectory_;
     SDL_Renderer* renderer_ = nullptr;
+
+    // Residency
+    std::size_t memoryBudget_ = 0;
+    std::size_t residentBytes_ = 0;
+    std::uint64_t frame_ = 0;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+    std::uint64_t evictions_ = 0;
+
+    AtlasOptions atlasOptions_;
+    std::vector<AtlasPage> pages_;
+    // Placements read by loadAtlasLayout(), whose pages are not used for packing, and the
+    // slots of evicted images, which their pages keep reserved
+    std::unordered_map<std::string, AtlasPlacement> atlasLayout_;
+    std::size_t layoutPageCount_ = 0;
+
+    // Asynchronous loading. decodeQueue_, decoded_ and generation_ are shared with the
+    // workers and guarded by mutex_; everything else is only touched on the render thread.
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::deque<DecodeRequest> decodeQueue_;
+    std::vector<DecodeResult> decoded_;
+    unsigned generation_ = 0;
+    bool stopping_ = false;
+
+    std::deque<DecodeResult> uploads_;
+    std::unordered_map<TextureId, std::vector<std::size_t>> pending_;
+    std::unordered_map<std::size_t, PreloadGroup> preloadGroups_;
+    std::vector<PreloadCallback> completedPreloads_;
+    std::size_t nextPreloadGroup_ = 0;
+};
+
+/**
+ * Reference-counted handle that keeps a cached texture resident.
+ * Handles must only be created, copied and destroyed on the render thread.
+ */
+class TextureHandle {
+public:
+    TextureHandle() = default;
+    TextureHandle(const TextureHandle& other);
+    TextureHandle(TextureHandle&& other) noexcept;
+    TextureHandle& operator=(TextureHandle other) noexcept;
+    ~TextureHandle();
+
+    /// The texture, or Cache::MISSING_TEXTURE if the handle is empty or was cleared
+    const Texture& get() const;
+    const Texture& operator*() const { return get(); }
+    const Texture* operator->() const { return &get(); }
+    explicit operator bool() const;
+    TextureId getId() const { return id_; }
+
+private:
+    friend class Cache;
+
+    explicit TextureHandle(TextureId id);
+
+    TextureId id_ = NULL_TEXTURE_ID;
 };
 
-}  // namespace ast
\ No newline at end of file
+}  // namespace ast
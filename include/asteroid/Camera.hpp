@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Rect.hpp"
+#include "Vector2.hpp"
+#include "ecs/Component.hpp"
+
+namespace ast {
+
+/// Maps a region of the world onto a region of the render target
+struct Camera : Component {
+    Camera() = default;
+    Camera(Vector2 position, const Rect& viewport, float zoom = 1.0f)
+        : position(position), viewport(viewport), zoom(zoom) {}
+
+    /// The world area shown in the viewport
+    Rect getVisibleArea() const {
+        const Vector2 size = Vector2(viewport.w, viewport.h) / zoom;
+        return {position - size * 0.5f, size};
+    }
+
+    Vector2 worldToScreen(Vector2 point) const {
+        return (point - position) * zoom + Vector2(viewport.x + viewport.w * 0.5f,
+                                                   viewport.y + viewport.h * 0.5f);
+    }
+
+    Rect worldToScreen(const Rect& rect) const {
+        return {worldToScreen(Vector2(rect.x, rect.y)), Vector2(rect.w, rect.h) * zoom};
+    }
+
+    Vector2 screenToWorld(Vector2 point) const {
+        return (point - Vector2(viewport.x + viewport.w * 0.5f, viewport.y + viewport.h * 0.5f)) /
+                   zoom +
+               position;
+    }
+
+    // World point shown at the center of the viewport
+    Vector2 position;
+    // Region of the render target drawn to, in render coordinates
+    Rect viewport;
+    float zoom = 1.0f;
+};
+
+struct CullStats {
+    std::size_t tested = 0;
+    std::size_t visible = 0;
+
+    std::size_t culled() const { return tested - visible; }
+};
+
+/**
+ * Find the rects that overlap an area, testing four rects at a time with SIMD.
+ * Rects that only touch the edges of the area are not visible.
+ * @param bounds The rects to test, e.g. the world bounds of every sprite
+ * @param area The visible area, e.g. Camera::getVisibleArea()
+ * @param visible Receives the indices of the visible rects, in order; not cleared
+ * @return The number of visible rects
+ */
+std::size_t cullRects(std::span<const Rect> bounds, const Rect& area,
+                      std::vector<std::uint32_t>& visible);
+
+}  // namespace ast
@@ -1,32 +1,167 @@
 #pragma once
 
+#include <array>
+#include <condition_variable>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Color.hpp"
+#include "JobSystem.hpp"
+#include "RenderQueue.hpp"
+#include "RenderSnapshot.hpp"
 #include "Scene.hpp"
+#include "SpriteBatch.hpp"
 #include "Timer.hpp"
 
 class SDL_Window;
 class SDL_Renderer;
+class SDL_Surface;
 
 namespace ast {
 
 class Engine final {
 public:
-    Engine(const std::string& title, int width, int height, const std::filesystem::path& assetsDir);
+    enum class Mode {
+        Windowed,
+        // No window or renderer, for servers and simulation tests; textures cannot be loaded
+        Headless,
+        // No window; draws with a software renderer into an offscreen surface
+        HeadlessSoftware,
+    };
+
+    /**
+     * Create the engine. Headless modes need no display or audio device: audio is mixed
+     * offline, in step with the simulation.
+     * @param title The window title
+     * @param width The window or surface width
+     * @param height The window or surface height
+     * @param assetsDir The assets directory or pack
+     * @param mode Whether to open a window
+     */
+    Engine(const std::string& title, int width, int height, const std::filesystem::path& assetsDir,
+           Mode mode = Mode::Windowed);
     ~Engine();
 
     // bool init();
+
+    /**
+     * Run the main loop until quit() is called.
+     * The simulation advances in fixed steps of getFixedTimestep() seconds, as many per
+     * frame as the elapsed time requires, while rendering happens once per frame. Time
+     * left over in the accumulator is passed to render() as an interpolation factor.
+     */
     void run();
+
+    /**
+     * Run frames as fast as possible, each advancing the simulation by exactly one fixed
+     * step, so that runs are deterministic and measure pure simulation throughput.
+     * @param frameCount The number of frames to run
+     * @return The number of frames run; fewer if quit() was called
+     */
+    int runFrames(int frameCount);
     void quit();
 
     void handleEvents();
+    /// Advance the simulation by one fixed step, forwarded to the active scene
     void update(float dt);
+    /**
+     * Copy what the renderer needs out of the simulation state. Called after the update
+     * steps of every frame, on the same thread as update(); forwarded to the active scene.
+     * @param snapshot An empty snapshot to fill
+     */
+    void extract(RenderSnapshot& snapshot);
+    /**
+     * Draw the current frame from getRenderSnapshot(), then let the active scene draw,
+     * then the commands recorded into getRenderQueue().
+     * @param alpha How far the frame lies between the last two simulation steps, in [0, 1)
+     */
+    void render(float alpha);
+
+    /**
+     * Make a scene the active one. The engine owns it and drives its update(), extract()
+     * and render(). The switch happens at the start of the next frame, so a scene may
+     * replace itself from its own update().
+     * @param scene The new scene, or nullptr for none
+     */
+    void setScene(std::unique_ptr<Scene> scene);
+    /// The active scene, or nullptr
+    Scene* getScene() const { return scene_.get(); }
     void clear(const Color& color);
     void present();
     // void destroy();
 
+    /**
+     * Set the duration of a simulation step.
+     * @param seconds The step, e.g. 1.0 / 120 for a 120 Hz simulation
+     */
+    void setFixedTimestep(double seconds);
+    double getFixedTimestep() const { return fixedTimestep_; }
+
+    /**
+     * Limit the number of steps run in one frame. After a slow frame the simulation drops
+     * the remaining time instead of falling further behind.
+     * @param steps The maximum number of steps per frame
+     */
+    void setMaxUpdateSteps(int steps);
+    int getMaxUpdateSteps() const { return maxUpdateSteps_; }
+
+    /**
+     * Choose how frames are paced, enabling renderer vsync for Timer::Pacing::VSync.
+     * @param pacing The pacing mode
+     */
+    void setPacing(Timer::Pacing pacing);
+
+    /// Interpolation factor of the current frame, see render()
+    float getInterpolationAlpha() const { return alpha_; }
+
+    /**
+     * Simulate frame N + 1 on a worker thread while the main thread renders frame N,
+     * at the cost of one frame of latency. Takes effect on the next run().
+     * While pipelined, update() and extract() run on the worker concurrently with
+     * render() and present(), so:
+     * - render() may only read the snapshot from getRenderSnapshot() and the Cache;
+     * - update() and extract() must not use the renderer or load textures, and refer to
+     *   textures by TextureId; Cache::getTextureId() is safe to call from them;
+     * - events are published and Audio::update() runs on the main thread while the
+     *   worker is idle, so both remain safe to use from update().
+     * @param pipelined Whether to pipeline simulation and rendering
+     */
+    void setPipelined(bool pipelined) { pipelined_ = pipelined; }
+    bool isPipelined() const { return pipelined_; }
+
+    Mode getMode() const { return mode_; }
+    /// The offscreen surface drawn to in HeadlessSoftware mode, otherwise null
+    SDL_Surface* getSurface() const { return surface_; }
+
+    /// The job system shared by the engine and game code
+    JobSystem& getJobSystem() { return *jobs_; }
+
+    /**
+     * Restart the job system with a different number of workers. Must not be called while
+     * jobs are running.
+     * @param workerCount The number of worker threads
+     */
+    void setWorkerCount(std::size_t workerCount);
+
+    /// Batches sprites drawn in render(); the snapshot's sprites are drawn through it
+    SpriteBatch& getSpriteBatch() { return spriteBatch_; }
+
+    /// Sprites of the last snapshot drawn and culled, see drawSnapshot()
+    const CullStats& getCullStats() const { return cullStats_; }
+
+    /**
+     * Commands recorded here are sorted and drawn at the end of render(), then discarded.
+     * Record them from render(), including from jobs it waits for.
+     */
+    RenderQueue& getRenderQueue() { return renderQueue_; }
+
+    /// The snapshot drawn this frame; only read it from render()
+    const RenderSnapshot& getRenderSnapshot() const { return snapshots_[frontSnapshot_]; }
+
     std::filesystem::path assetsDirectory_;
     std::string title_;
     Timer timer_;
@@ -35,6 +170,53 @@ public:
     int width_;
     int height_;
     bool running_;
+    double fixedTimestep_ = 1.0 / 120.0;
+    int maxUpdateSteps_ = 8;
+    // Simulation time not yet consumed by update()
+    double accumulator_ = 0.0;
+    float alpha_ = 0.0f;
+    std::uint64_t step_ = 0;
+
+private:
+    void startLoop();
+    void stopLoop();
+    // Everything in a frame but the pacing
+    void runFrame(int steps);
+    // Run the update steps and take a snapshot of the result
+    void simulate(int steps, float alpha, RenderSnapshot& snapshot);
+    void simulationLoop();
+    void drawSnapshot(const RenderSnapshot& snapshot, float alpha);
+
+    Mode mode_;
+    SDL_Surface* surface_ = nullptr;
+    std::unique_ptr<Scene> scene_;
+    // Set by setScene(), made active when the next frame starts
+    std::unique_ptr<Scene> nextScene_;
+    bool sceneChanged_ = false;
+    // Offline audio rendered per frame, with the fraction of a frame carried over
+    std::vector<float> audioBuffer_;
+    double audioFrames_ = 0.0;
+
+    std::unique_ptr<JobSystem> jobs_ = std::make_unique<JobSystem>();
+    bool pipelined_ = false;
+    bool loopPipelined_ = false;  // pipelined_ as of the start of the running loop
+    std::array<RenderSnapshot, 2> snapshots_;
+    SpriteBatch spriteBatch_;
+    // Conservative bounds of the snapshot's sprites, and the indices of the visible ones
+    std::vector<Rect> spriteBounds_;
+    std::vector<std::uint32_t> visibleSprites_;
+    CullStats cullStats_;
+    RenderQueue renderQueue_;
+    int frontSnapshot_ = 0;
+
+    // Hand-off between the main thread and the simulation thread
+    std::thread simulationThread_;
+    std::mutex simulationMutex_;
+    std::condition_variable simulationChanged_;
+    int pendingSteps_ = 0;
+    float pendingAlpha_ = 0.0f;
+    bool simulating_ = false;
+    bool stopSimulation_ = false;
 };
 
 }  // namespace ast
\ No newline at end of file
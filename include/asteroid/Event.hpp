@@ -7,4 +7,8 @@ struct WindowResizeEvent {
     int height;
 };
 
+/// Render target contents were lost, or the render device was reset and every texture
+/// must be created again
+struct RenderTargetsResetEvent {};
+
 }  // namespace ast::events
\ No newline at end of file
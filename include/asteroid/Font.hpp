@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "AtlasPacker.hpp"
+#include "Color.hpp"
+#include "Hash.hpp"
+#include "Rect.hpp"
+#include "Vector2.hpp"
+
+class SDL_Renderer;
+class SDL_Texture;
+struct TTF_Font;
+
+namespace ast {
+
+class SpriteBatch;
+
+/**
+ * A TrueType font drawn from glyph atlases.
+ * Each glyph is rasterized once, the first time it is laid out, and packed into an atlas
+ * page shared by the font's glyphs. Text is drawn as one quad per glyph through a
+ * SpriteBatch, so every label using the font batches into a draw call per page.
+ * Glyphs are rendered white and tinted by the draw color.
+ */
+class Font {
+public:
+    /// A glyph placed relative to the top-left corner of the text
+    struct GlyphQuad {
+        SDL_Texture* page;
+        Rect source;
+        Rect destination;
+    };
+
+    struct TextLayout {
+        std::vector<GlyphQuad> quads;
+        Vector2 size;
+    };
+
+    /**
+     * Open a font.
+     * @param renderer The renderer creating the atlas pages
+     * @param file The font file, which may be inside an asset pack
+     * @param pointSize The size to rasterize the glyphs at
+     * @param pageSize The width and height of the atlas pages
+     */
+    Font(SDL_Renderer* renderer, const std::filesystem::path& file, float pointSize,
+         int pageSize = 512);
+    ~Font();
+    Font(const Font&) = delete;
+    Font& operator=(const Font&) = delete;
+
+    bool isLoaded() const { return font_ != nullptr; }
+    /// Distance between the tops of two lines
+    float getLineHeight() const { return lineHeight_; }
+
+    /**
+     * Lay out UTF-8 text, applying kerning and breaking lines at '\n'.
+     * @param text The text
+     * @param layout Replaced by the glyphs of the text
+     */
+    void layout(std::string_view text, TextLayout& layout);
+
+    /**
+     * Lay out text once and keep the result, for labels that rarely change.
+     * @param text The text
+     * @return The layout, valid until the cache is cleared; layouts are keyed by the whole
+     * string, and the cache clears itself when it holds more than MAX_CACHED_LAYOUTS strings
+     */
+    const TextLayout& getLayout(std::string_view text);
+    void clearLayoutCache() { layouts_.clear(); }
+
+    /// Size of the text when drawn
+    Vector2 measure(std::string_view text);
+
+    /**
+     * Queue text into a batch.
+     * @param batch The batch
+     * @param text The UTF-8 text, laid out again on every call
+     * @param position The top-left corner of the text
+     * @param color The text color
+     * @param layer The batch layer
+     */
+    void draw(SpriteBatch& batch, std::string_view text, Vector2 position,
+              Color color = Color::WHITE, int layer = 0);
+    void draw(SpriteBatch& batch, const TextLayout& layout, Vector2 position,
+              Color color = Color::WHITE, int layer = 0) const;
+
+    std::size_t getGlyphCount() const { return glyphs_.size(); }
+    std::size_t getPageCount() const { return pages_.size(); }
+
+    static constexpr std::size_t MAX_CACHED_LAYOUTS = 1024;
+
+private:
+    struct Glyph {
+        SDL_Texture* page = nullptr;  // Null for glyphs without pixels, e.g. spaces
+        Rect source;
+        float offsetX = 0.0f;
+        float advance = 0.0f;
+    };
+
+    struct Page {
+        SDL_Texture* handle;
+        AtlasPacker packer;
+    };
+
+    const Glyph& getGlyph(std::uint32_t codepoint);
+    // Rasterize a glyph into an atlas page
+    bool addToAtlas(std::uint32_t codepoint, Glyph& glyph);
+    float getKerning(std::uint32_t previous, std::uint32_t codepoint);
+
+    SDL_Renderer* renderer_;
+    TTF_Font* font_ = nullptr;
+    int pageSize_;
+    float lineHeight_ = 0.0f;
+    std::vector<Page> pages_;
+    std::unordered_map<std::uint32_t, Glyph> glyphs_;
+    // Keyed by the pair of codepoints
+    std::unordered_map<std::uint64_t, float> kerning_;
+    std::unordered_map<std::string, TextLayout, StringHash, std::equal_to<>> layouts_;
+    TextLayout scratch_;
+};
+
+}  // namespace ast
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace ast {
+
+/**
+ * 64-bit FNV-1a hash of a string. Being constexpr, names known at compile time can be
+ * hashed for free, e.g. constexpr auto PLAYER = hashString("player.png");
+ * @param str The string to hash
+ * @return The hash value
+ */
+constexpr std::uint64_t hashString(std::string_view str) noexcept {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : str) {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/// Transparent hash for containers keyed by std::string, so they can be searched with a
+/// std::string_view without building a string
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view str) const noexcept {
+        return static_cast<std::size_t>(hashString(str));
+    }
+};
+
+}  // namespace ast
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ast {
+
+class JobSystem;
+
+/**
+ * Counts the unfinished jobs of a group. Jobs submitted with a counter increment it and
+ * decrement it when they finish; jobs can also be made to start only once a counter
+ * reaches zero. Wait for a counter with JobSystem::wait() before destroying it.
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool isDone() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    struct Continuation {
+        std::function<void()> job;
+        JobCounter* counter;
+    };
+
+    std::atomic<int> pending_{0};
+    // Guards continuations_ and the transition to zero
+    std::mutex mutex_;
+    std::vector<Continuation> continuations_;
+};
+
+/**
+ * Runs jobs on a pool of worker threads.
+ * Each worker owns a deque: it pushes and pops its own jobs at the back, which keeps
+ * recently submitted work hot in its cache, and idle workers steal from the front of
+ * the others. Jobs submitted from threads that are not workers go to a shared queue.
+ * Threads waiting for a counter run queued jobs instead of blocking, so waiting inside
+ * a job cannot deadlock and a JobSystem with no workers still makes progress.
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * Start the workers.
+     * @param workerCount The number of worker threads; defaults to one less than the number
+     * of hardware threads, leaving a core to the main thread
+     */
+    explicit JobSystem(std::size_t workerCount = getDefaultWorkerCount());
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * Queue a job.
+     * @param job The job
+     * @param counter Incremented now and decremented when the job finishes, may be null
+     */
+    void submit(Job job, JobCounter* counter = nullptr);
+
+    /**
+     * Queue a job once every job counted by dependency has finished.
+     * @param dependency The jobs to wait for
+     * @param job The job
+     * @param counter Incremented now and decremented when the job finishes, may be null
+     */
+    void submitAfter(JobCounter& dependency, Job job, JobCounter* counter = nullptr);
+
+    /**
+     * Run func over [0, count) split into batches spread across the workers, and wait.
+     * @param count The number of items
+     * @param batchSize The number of items per job
+     * @param func Called with the begin and end of each batch
+     */
+    void parallelFor(std::size_t count, std::size_t batchSize,
+                     const std::function<void(std::size_t, std::size_t)>& func);
+
+    /// Run queued jobs on the calling thread until every job counted by counter has finished
+    void wait(JobCounter& counter);
+
+    std::size_t getWorkerCount() const { return workers_.size(); }
+
+    static std::size_t getDefaultWorkerCount();
+
+private:
+    struct Task {
+        Job job;
+        JobCounter* counter = nullptr;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void push(Task task);
+    // Pop from the caller's own queue, or steal from another; false if all are empty
+    bool tryRun();
+    void run(Task& task);
+    void finish(JobCounter& counter);
+    void workerLoop(std::size_t index);
+
+    // Index 0 is shared by threads that are not workers; worker i owns index i + 1
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> queuedCount_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wakeCondition_;
+    std::atomic<bool> stopping_{false};
+};
+
+}  // namespace ast
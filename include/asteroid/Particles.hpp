@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <SDL3/SDL_render.h>
+
+#include "Camera.hpp"
+#include "Color.hpp"
+#include "QuadIndices.hpp"
+#include "Texture.hpp"
+#include "Vector2.hpp"
+#include "ecs/System.hpp"
+
+namespace ast {
+
+/// Initial state of a particle
+struct ParticleSpawn {
+    Vector2 position;
+    Vector2 velocity;
+    float lifetime = 1.0f;  // In seconds
+    float size = 4.0f;
+    // Interpolated over the lifetime of the particle
+    Color startColor = Color::WHITE;
+    Color endColor = Color(255, 255, 255, 0);
+};
+
+/**
+ * Fixed-capacity storage for particles, one array per attribute.
+ * update() integrates four particles per instruction with SIMD, then removes dead
+ * particles by moving the last live particle into their slot, so the live particles always
+ * occupy the first size() slots and the pool never allocates after construction.
+ */
+class ParticlePool {
+public:
+    explicit ParticlePool(std::size_t capacity);
+
+    /**
+     * Add a particle.
+     * @param spawn The initial state
+     * @return false if the pool is full
+     */
+    bool spawn(const ParticleSpawn& spawn);
+
+    /**
+     * Advance every particle and remove those that outlived their lifetime.
+     * @param dt The time step in seconds
+     * @param acceleration Added to every velocity, e.g. gravity
+     * @param drag Fraction of the velocity lost per second
+     * @return The number of particles removed
+     */
+    std::size_t update(float dt, Vector2 acceleration = {}, float drag = 0.0f);
+
+    void clear();
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    // The first size() elements of each array are the live particles
+    const float* getX() const { return x_.data(); }
+    const float* getY() const { return y_.data(); }
+    const float* getVelocityX() const { return velocityX_.data(); }
+    const float* getVelocityY() const { return velocityY_.data(); }
+    const float* getAge() const { return age_.data(); }
+    const float* getLifetime() const { return lifetime_.data(); }
+    const float* getSize() const { return particleSize_.data(); }
+    const Color* getStartColor() const { return startColor_.data(); }
+    const Color* getEndColor() const { return endColor_.data(); }
+
+private:
+    void remove(std::size_t index);
+
+    std::size_t capacity_;
+    std::size_t size_ = 0;
+    // Padded to a multiple of the SIMD width so the last vector never needs a scalar tail
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> velocityX_;
+    std::vector<float> velocityY_;
+    std::vector<float> age_;
+    std::vector<float> lifetime_;
+    std::vector<float> particleSize_;
+    std::vector<Color> startColor_;
+    std::vector<Color> endColor_;
+};
+
+/// Emits particles at a position, e.g. an explosion or a thruster attached to a ship
+struct ParticleEmitter : Component {
+    ParticleEmitter() = default;
+    ParticleEmitter(Vector2 position, float rate) : position(position), rate(rate) {}
+
+    Vector2 position;
+    float rate = 0.0f;  // Particles per second while emitting
+    bool emitting = true;
+    // Particles spawned at the next update, for one-off bursts; cleared by the system
+    int burst = 0;
+    // Direction in degrees, clockwise from the positive x axis, and the width of the cone
+    float direction = 0.0f;
+    float spread = 360.0f;
+    float minSpeed = 50.0f;
+    float maxSpeed = 100.0f;
+    float minLifetime = 0.5f;
+    float maxLifetime = 1.0f;
+    float size = 4.0f;
+    Color startColor = Color::WHITE;
+    Color endColor = Color(255, 255, 255, 0);
+    // Fraction of a particle carried over between updates; managed by ParticleSystem
+    float pending = 0.0f;
+};
+
+/**
+ * Spawns particles from every ParticleEmitter into one ParticlePool, simulates them,
+ * and draws them all with a single SDL_RenderGeometry() call.
+ * Particles are not entities: once spawned they no longer depend on their emitter.
+ * Not pipeline safe: draw() reads the pool that update() writes, so only call it from
+ * render() while the Engine is not pipelined.
+ */
+class ParticleSystem : public System<ParticleEmitter> {
+public:
+    struct Stats {
+        std::size_t alive = 0;
+        std::size_t spawned = 0;  // In the last update
+        std::size_t died = 0;     // In the last update
+        std::size_t dropped = 0;  // Not spawned in the last update because the pool was full
+    };
+
+    ParticleSystem(Registry& registry, std::size_t capacity = 16384);
+
+    void update(float dt) override;
+
+    /**
+     * Draw every particle as a square centered on its position.
+     * @param renderer The renderer
+     * @param camera The camera the particle positions are relative to, or null to use
+     * render coordinates
+     */
+    void draw(SDL_Renderer* renderer, const Camera* camera = nullptr);
+
+    /// The texture drawn for each particle; without one particles are solid squares
+    void setTexture(TextureId texture) { texture_ = texture; }
+    void setAcceleration(Vector2 acceleration) { acceleration_ = acceleration; }
+    void setDrag(float drag) { drag_ = drag; }
+
+    ParticlePool& getPool() { return pool_; }
+    const Stats& getStats() const { return stats_; }
+
+private:
+    void emit(const ParticleEmitter& emitter, int count);
+
+    ParticlePool pool_;
+    TextureId texture_ = NULL_TEXTURE_ID;
+    Vector2 acceleration_;
+    float drag_ = 0.0f;
+    std::minstd_rand random_;
+    Stats stats_;
+    std::vector<SDL_Vertex> vertices_;
+    QuadIndices indices_;
+};
+
+}  // namespace ast
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Audio.hpp"
+#include "Vector2.hpp"
+#include "ecs/System.hpp"
+
+namespace ast {
+
+/// The entity that hears positional sounds
+struct AudioListener : Component {
+    AudioListener() = default;
+    explicit AudioListener(Vector2 position) : position(position) {}
+
+    Vector2 position;
+};
+
+/// A sound played at a position in the world
+struct AudioEmitter : Component {
+    AudioEmitter() = default;
+    AudioEmitter(std::string sound, Vector2 position, int loops = 0)
+        : sound(std::move(sound)), position(position), loops(loops) {}
+
+    std::string sound;
+    Vector2 position;
+    float gain = 1.0f;
+    // Full volume up to minDistance from the listener, fading linearly to silence at maxDistance
+    float minDistance = 64.0f;
+    float maxDistance = 1024.0f;
+    int priority = 0;
+    // 0 plays continuously while the emitter is audible; otherwise the sound plays that many
+    // times when triggered
+    int loops = 0;
+    // Set to start the sound, cleared by the system
+    bool triggered = false;
+    // Managed by PositionalAudioSystem
+    VoiceId voice = NULL_VOICE_ID;
+    // Gain after distance attenuation and stereo pan, from the last update
+    float audibleGain = 0.0f;
+    float pan = 0.0f;
+};
+
+/**
+ * Plays AudioEmitter sounds relative to the AudioListener.
+ * Every update computes distance attenuation and stereo pan for all emitters in one
+ * SIMD pass over their positions. Inaudible emitters, and the quietest ones beyond the
+ * voice budget, are culled before they take a voice. The gain and pan of all playing
+ * emitters are then sent to Audio in a single batch.
+ */
+class PositionalAudioSystem : public System<AudioEmitter> {
+public:
+    struct Stats {
+        std::size_t emitters = 0;
+        std::size_t audible = 0;
+        std::size_t playing = 0;
+        std::size_t culled = 0;  // Audible but beyond the voice budget
+    };
+
+    PositionalAudioSystem(Registry& registry, std::size_t maxVoices = 24);
+
+    void update(float dt) override;
+    void onEntityRemoved(Entity entity) override;
+
+    /**
+     * Set the listener entity.
+     * @param listener An entity with an AudioListener, or NULL_ENTITY to use the first one
+     */
+    void setListener(Entity listener) { listener_ = listener; }
+
+    /// Maximum number of voices used by emitters; the loudest emitters are kept
+    void setMaxVoices(std::size_t maxVoices) { maxVoices_ = maxVoices; }
+
+    /// Emitters quieter than this are treated as inaudible
+    void setAudibilityThreshold(float gain) { threshold_ = gain; }
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    Vector2 getListenerPosition() const;
+    // Fill gains_ and pans_ from the gathered emitter data
+    void computeGainAndPan(Vector2 listener);
+
+    Entity listener_ = NULL_ENTITY;
+    std::size_t maxVoices_;
+    float threshold_ = 0.001f;
+    Stats stats_;
+
+    // Emitter data gathered as structure of arrays for the SIMD pass
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> minDistance_;
+    std::vector<float> inverseRange_;
+    std::vector<float> emitterGain_;
+    std::vector<float> gains_;
+    std::vector<float> pans_;
+
+    std::vector<std::size_t> audible_;
+    std::vector<Audio::VoiceUpdate> updates_;
+};
+
+}  // namespace ast
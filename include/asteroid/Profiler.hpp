@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <typeinfo>
+
+namespace ast {
+
+/**
+ * CPU profiler recording named zones with nanosecond timestamps.
+ * Each thread writes to its own fixed-size ring buffer without locking, keeping its most
+ * recent EVENTS_PER_THREAD zones; older zones are overwritten. The buffer of a thread that
+ * has exited is kept for export until the next clear(). Zones nest by time, so
+ * the trace viewer reconstructs the hierarchy.
+ * Use the AST_PROFILE_ZONE macros, which compile to nothing in release builds.
+ * The recorded zones can be written in the Chrome trace format, which Perfetto and
+ * chrome://tracing open.
+ */
+class Profiler {
+public:
+    struct Event {
+        const char* name;  // Must outlive the profiler, e.g. a string literal
+        std::uint64_t start;
+        std::uint64_t end;
+    };
+
+    /// Records a zone from its construction to its destruction
+    class Zone {
+    public:
+        explicit Zone(const char* name) : name_(name), start_(now()) {}
+        ~Zone() { record(name_, start_, now()); }
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name_;
+        std::uint64_t start_;
+    };
+
+    static constexpr std::size_t EVENTS_PER_THREAD = 1 << 16;
+
+    /// Nanoseconds since the profiler started
+    static std::uint64_t now();
+    static void record(const char* name, std::uint64_t start, std::uint64_t end);
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /// Name the calling thread in exported traces
+    static void setThreadName(const char* name);
+
+    /**
+     * Get a readable, interned name for a type, suitable as a zone name.
+     * @param type The type
+     * @return The demangled name, valid until the program exits
+     */
+    static const char* getTypeName(const std::type_info& type);
+
+    /// Discard the zones recorded so far and free the buffers of threads that have exited
+    static void clear();
+
+    /// Number of threads with a buffer, including exited ones not yet freed by clear()
+    static std::size_t getThreadBufferCount();
+
+    /**
+     * Write the recorded zones of every thread as Chrome trace JSON.
+     * @param path The file to write
+     * @return true on success
+     */
+    static bool exportChromeTrace(const std::filesystem::path& path);
+};
+
+}  // namespace ast
+
+#ifndef NDEBUG
+
+#define AST_PROFILE_CONCAT_IMPL(a, b) a##b
+#define AST_PROFILE_CONCAT(a, b) AST_PROFILE_CONCAT_IMPL(a, b)
+#define AST_PROFILE_ZONE(name) \
+    ::ast::Profiler::Zone AST_PROFILE_CONCAT(astProfileZone, __LINE__)(name)
+#define AST_PROFILE_FUNCTION() AST_PROFILE_ZONE(__func__)
+
+#else
+
+#define AST_PROFILE_ZONE(name) (void)0
+#define AST_PROFILE_FUNCTION() (void)0
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <SDL3/SDL_render.h>
+
+namespace ast {
+
+/**
+ * The index array for drawing quads with SDL_RenderGeometry().
+ * A quad is four vertices clockwise from the top left. Every quad uses the same pattern
+ * relative to its first vertex, so one array serves any run of quads as long as the run
+ * passes its own vertex pointer. The array only grows.
+ */
+class QuadIndices {
+public:
+    /**
+     * Draw quads with a single SDL_RenderGeometry() call.
+     * @param renderer The renderer
+     * @param texture The texture, or null for solid quads
+     * @param vertices Four vertices per quad
+     * @param quadCount The number of quads
+     */
+    void draw(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Vertex* vertices,
+              std::size_t quadCount);
+
+private:
+    std::vector<int> indices_;
+};
+
+}  // namespace ast
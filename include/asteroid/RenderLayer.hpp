@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "Event.hpp"
+#include "EventSubscriber.hpp"
+
+class SDL_Renderer;
+class SDL_Texture;
+
+namespace ast {
+
+/**
+ * A part of the frame drawn by a function, such as a background or a HUD.
+ * A static layer draws into a cached target texture only when it has been invalidated,
+ * and every frame composites the cache over the frame with a single copy. The cache has
+ * the size of the render coordinate space, e.g. the logical presentation, so on a scaled
+ * window a static layer may look softer than one drawn directly.
+ * Layers that are not static call their function every frame.
+ */
+class RenderLayer : public EventSubscriber<events::RenderTargetsResetEvent> {
+public:
+    /// Draws the layer in render coordinates; anything it batches must be flushed before it returns
+    using DrawFunction = std::function<void(SDL_Renderer*)>;
+
+    explicit RenderLayer(DrawFunction draw, bool isStatic = false);
+    ~RenderLayer() override;
+    RenderLayer(const RenderLayer&) = delete;
+    RenderLayer& operator=(const RenderLayer&) = delete;
+
+    /// Cache the layer or draw it every frame; releases the cache when turned off
+    void setStatic(bool isStatic);
+    bool isStatic() const { return static_; }
+
+    /// Draw a static layer again on its next render()
+    void invalidate() { valid_ = false; }
+    bool isValid() const { return valid_; }
+
+    /**
+     * Draw the layer onto the current render target.
+     * @param renderer The renderer
+     */
+    void render(SDL_Renderer* renderer);
+
+    /// Number of times the function drew into the cache
+    std::uint64_t getRedrawCount() const { return redrawCount_; }
+
+protected:
+    // A device reset leaves the cache unusable, so it is created again on the next render()
+    void onEvent(const events::RenderTargetsResetEvent& event) override { releaseCache(); }
+
+private:
+    void releaseCache();
+    // Make sure the cache exists with the given size; false if it cannot be created
+    bool prepareCache(SDL_Renderer* renderer, int width, int height);
+
+    DrawFunction draw_;
+    SDL_Texture* cache_ = nullptr;
+    int cacheWidth_ = 0;
+    int cacheHeight_ = 0;
+    bool static_;
+    bool valid_ = false;
+    std::uint64_t redrawCount_ = 0;
+};
+
+}  // namespace ast
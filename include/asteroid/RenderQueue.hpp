@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Color.hpp"
+#include "Rect.hpp"
+#include "Texture.hpp"
+
+namespace ast {
+
+class SpriteBatch;
+
+/// A textured quad recorded into a RenderQueue
+struct RenderCommand {
+    std::uint64_t key = 0;  // See RenderQueue::makeKey()
+    TextureId texture = NULL_TEXTURE_ID;
+    float rotation = 0.0f;  // In degrees
+    // Region of the image to draw, in its pixels; empty for the whole image
+    Rect source;
+    Rect destination;
+    Color color = Color::WHITE;
+};
+
+/**
+ * Decouples recording draws from submitting them to the renderer.
+ * Any thread records commands into its own buffer from getBuffer(), without locking, e.g.
+ * from JobSystem jobs that each walk part of a scene. execute() then merges the buffers,
+ * radix sorts the commands by key, and draws them in order on the render thread.
+ * Commands refer to textures by TextureId, which is resolved through the Cache only when
+ * executed. Commands with equal keys are drawn in recording order within a thread; their
+ * order across threads is unspecified.
+ */
+class RenderQueue {
+public:
+    /// Commands recorded by one thread
+    class Buffer {
+    public:
+        void record(const RenderCommand& command) { commands_.push_back(command); }
+
+        /**
+         * Record a sprite showing a whole texture.
+         * @param texture The texture
+         * @param destination Where to draw, in render coordinates
+         * @param layer Lower layers are drawn first
+         * @param depth Orders the sprites of a layer sharing a texture, lower first
+         * @param rotation Clockwise rotation around the center of destination, in degrees
+         * @param color Multiplied with the texture color
+         */
+        void draw(TextureId texture, const Rect& destination, int layer = 0, float depth = 0.0f,
+                  float rotation = 0.0f, Color color = Color::WHITE) {
+            commands_.push_back({makeKey(layer, texture, depth), texture, rotation, {},
+                                 destination, color});
+        }
+
+        std::size_t size() const { return commands_.size(); }
+
+    private:
+        friend class RenderQueue;
+
+        std::vector<RenderCommand> commands_;
+    };
+
+    RenderQueue() = default;
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    /**
+     * Pack a sort key: 16 bits of layer, then 24 bits of texture id, then 24 bits of depth.
+     * Sorting by key groups the commands of a layer by texture, so that they batch.
+     * @param layer The layer, in [-32768, 32767]
+     * @param texture The texture id; ids beyond 24 bits share the top value
+     * @param depth Any float; only its 24 most significant bits are kept
+     * @return The key
+     */
+    static std::uint64_t makeKey(int layer, TextureId texture, float depth);
+
+    /// The calling thread's buffer, created on first use. Do not share it between threads.
+    Buffer& getBuffer();
+
+    /// Number of commands recorded since the last execute() or clear()
+    std::size_t size() const;
+
+    /**
+     * Merge and sort the recorded commands. Must not run while commands are being recorded.
+     * @return The commands in draw order, valid until the next recording, execute() or clear()
+     */
+    const std::vector<const RenderCommand*>& sort();
+
+    /**
+     * Sort the recorded commands and draw them through a batch, then clear the queue.
+     * Call on the render thread once recording has finished.
+     * @param batch The batch to draw with; flushed before returning
+     */
+    void execute(SpriteBatch& batch);
+
+    /// Drop the recorded commands, keeping the buffers' memory
+    void clear();
+
+private:
+    struct Entry {
+        std::uint64_t key;
+        const RenderCommand* command;
+    };
+
+    Buffer& findBuffer();
+
+    mutable std::mutex mutex_;  // Guards buffers_ and bufferIndices_
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+    std::unordered_map<std::thread::id, std::size_t> bufferIndices_;
+    // Distinguishes this queue in the threads' cached lookups
+    const std::uint64_t id_ = nextId_++;
+    inline static std::atomic<std::uint64_t> nextId_{1};
+
+    std::vector<Entry> entries_;
+    std::vector<Entry> scratch_;
+    std::vector<const RenderCommand*> sorted_;
+};
+
+}  // namespace ast
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Camera.hpp"
+#include "Color.hpp"
+#include "Rect.hpp"
+#include "Texture.hpp"
+
+namespace ast {
+
+/// A sprite as seen by the renderer
+struct SpriteDraw {
+    TextureId texture = NULL_TEXTURE_ID;
+    // Destination after the previous and the latest simulation step, interpolated when drawn;
+    // in world coordinates when the snapshot has a camera
+    Rect previous;
+    Rect current;
+    float rotation = 0.0f;  // In degrees
+    Color color = Color::WHITE;
+    int layer = 0;  // Lower layers are drawn first
+};
+
+/**
+ * Everything needed to draw one frame, copied out of the simulation state by
+ * Engine::extract(). Renderers read only the snapshot and never the Registry, so the
+ * simulation can advance to the next frame while this one is drawn.
+ * Textures are referred to by id and resolved through the Cache when drawn.
+ */
+struct RenderSnapshot {
+    std::vector<SpriteDraw> sprites;
+    // Without a camera, sprites are placed in render coordinates
+    std::optional<Camera> camera;
+    // Number of simulation steps run before the snapshot was taken
+    std::uint64_t step = 0;
+    // Interpolation factor between the previous and the latest step, see Engine::render()
+    float alpha = 0.0f;
+
+    void clear() {
+        sprites.clear();
+        camera.reset();
+    }
+};
+
+}  // namespace ast
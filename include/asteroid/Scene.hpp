@@ -5,17 +5,31 @@
 namespace ast {
 
 class Engine;
+struct RenderSnapshot;
 
+/**
+ * A game state driven by the engine, see Engine::setScene().
+ * When the engine is pipelined, update() and extract() run on the simulation thread
+ * concurrently with render(); see Engine::setPipelined() for what each may touch.
+ */
 class Scene {
 public:
     explicit Scene(Engine* engine);
     virtual ~Scene() = default;
 
+    /// Advance the scene by one fixed step
     virtual void update(float dt) = 0;
+    /**
+     * Copy what the renderer needs out of the scene. Called after the update steps of
+     * every frame, on the same thread as update().
+     * @param snapshot An empty snapshot to fill
+     */
+    virtual void extract(RenderSnapshot& snapshot) {}
+    /// Draw on top of the snapshot, e.g. by recording into Engine::getRenderQueue()
     virtual void render() = 0;
 
     Engine* engine_;
     Registry registry_;
 };
 
-}
\ No newline at end of file
+}
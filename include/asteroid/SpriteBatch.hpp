@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL_render.h>
+
+#include "Color.hpp"
+#include "QuadIndices.hpp"
+#include "Rect.hpp"
+#include "Texture.hpp"
+
+namespace ast {
+
+/**
+ * Collects sprites over a frame and draws them with as few draw calls as possible.
+ * flush() sorts the sprites by layer, then by texture, and submits each run of sprites
+ * sharing a texture as a single SDL_RenderGeometry() call. Sprites packed into the same
+ * atlas page share a texture, so they batch together. Within a layer and texture, sprites
+ * are drawn in the order they were added.
+ * The vertex and index arrays are kept across frames, so a batch of steady size does not
+ * allocate.
+ */
+class SpriteBatch {
+public:
+    struct Stats {
+        std::size_t sprites = 0;
+        std::size_t drawCalls = 0;
+    };
+
+    explicit SpriteBatch(SDL_Renderer* renderer = nullptr) : renderer_(renderer) {}
+
+    void setRenderer(SDL_Renderer* renderer) { renderer_ = renderer; }
+    SDL_Renderer* getRenderer() const { return renderer_; }
+
+    /**
+     * Queue a sprite showing the whole texture.
+     * @param texture The texture; a null handle draws a rectangle filled with color
+     * @param destination Where to draw, in render coordinates
+     * @param rotation Clockwise rotation around the center of destination, in degrees
+     * @param color Multiplied with the texture color
+     * @param layer Lower layers are drawn first
+     */
+    void draw(const Texture& texture, const Rect& destination, float rotation = 0.0f,
+              Color color = Color::WHITE, int layer = 0) {
+        draw(texture.handle, texture.source, destination, rotation, color, layer);
+    }
+
+    /**
+     * Queue a sprite showing part of a texture.
+     * @param texture The texture, may be null
+     * @param source The region of the texture to draw, in pixels
+     * @param destination Where to draw, in render coordinates
+     * @param rotation Clockwise rotation around the center of destination, in degrees
+     * @param color Multiplied with the texture color
+     * @param layer Lower layers are drawn first
+     */
+    void draw(SDL_Texture* texture, const Rect& source, const Rect& destination,
+              float rotation = 0.0f, Color color = Color::WHITE, int layer = 0);
+
+    /// Sort and submit the queued sprites, then empty the batch
+    void flush();
+    /**
+     * Submit the queued sprites in the order they were added, then empty the batch. A new
+     * draw call starts whenever the texture or layer changes, so this suits sprites that
+     * the caller has already sorted.
+     */
+    void flushUnsorted();
+    /// Drop the queued sprites without drawing them
+    void clear() { sprites_.clear(); }
+
+    std::size_t size() const { return sprites_.size(); }
+    bool empty() const { return sprites_.empty(); }
+
+    /// Counts of the last flush()
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Sprite {
+        SDL_Texture* texture;
+        Rect source;
+        Rect destination;
+        float rotation;
+        Color color;
+        int layer;
+        std::uint32_t order;  // Keeps the sort stable
+    };
+
+    // Draw consecutive sprites sharing a texture and layer with one call each
+    void submit();
+    // Append the four corners of a sprite, with texture coordinates normalized by size
+    void appendQuad(const Sprite& sprite, float textureWidth, float textureHeight);
+
+    SDL_Renderer* renderer_;
+    std::vector<Sprite> sprites_;
+    std::vector<SDL_Vertex> vertices_;
+    QuadIndices indices_;
+    Stats stats_;
+};
+
+}  // namespace ast
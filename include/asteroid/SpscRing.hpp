@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ast {
+
+/**
+ * Lock-free ring buffer for exactly one producer thread and one consumer thread.
+ * The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        buffer_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * Append elements. Producer only.
+     * @param data The elements to append
+     * @param count The number of elements
+     * @return The number of elements appended, less than count if the ring is full
+     */
+    std::size_t write(const T* data, std::size_t count) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        count = std::min(count, buffer_.size() - (head - tail));
+        for (std::size_t i = 0; i < count; ++i) {
+            buffer_[(head + i) & mask_] = data[i];
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Remove elements from the front. Consumer only.
+     * @param data Receives the elements
+     * @param count The maximum number of elements
+     * @return The number of elements removed
+     */
+    std::size_t read(T* data, std::size_t count) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        count = std::min(count, head - tail);
+        for (std::size_t i = 0; i < count; ++i) {
+            data[i] = std::move(buffer_[(tail + i) & mask_]);
+        }
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    bool push(const T& value) { return write(&value, 1) == 1; }
+    bool pop(T& value) { return read(&value, 1) == 1; }
+
+    /// Number of readable elements; exact for the consumer, a lower bound for the producer
+    std::size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    std::size_t getFreeSpace() const { return buffer_.size() - size(); }
+    std::size_t getCapacity() const { return buffer_.size(); }
+
+private:
+    std::vector<T> buffer_;
+    std::size_t mask_ = 0;
+    // Free-running indices; kept on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+}  // namespace ast
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <SDL3/SDL_audio.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "SpscRing.hpp"
+
+class SDL_IOStream;
+
+namespace ast {
+
+/**
+ * An MP3 file decoded incrementally while it plays.
+ * A decoder thread calls decode() to keep a small window of converted PCM ahead of
+ * playback, and the mixer consumes it with read(). The file is read in small chunks
+ * through AssetPack::openIO(), so streams from a pack read straight from the mapping.
+ * Each playing voice owns its own StreamingSound.
+ */
+class StreamingSound {
+public:
+    StreamingSound(const StreamingSound&) = delete;
+    StreamingSound& operator=(const StreamingSound&) = delete;
+    ~StreamingSound();
+
+    /**
+     * Open an MP3 file for streaming.
+     * @param path The file
+     * @param spec The output format; must be SDL_AUDIO_F32
+     * @param bufferFrames The number of frames decoded ahead of playback
+     * @param loops Number of times to play, 0 to loop until stopped
+     * @return The stream, or nullptr if the file cannot be opened
+     */
+    static std::shared_ptr<StreamingSound> open(const std::filesystem::path& path,
+                                                const SDL_AudioSpec& spec,
+                                                std::size_t bufferFrames, int loops = 1);
+
+    /**
+     * Decode until the buffer is full or the file has ended. Decoder thread only.
+     * @return true if any frames were produced
+     */
+    bool decode();
+
+    /**
+     * Take decoded frames. Mixer thread only.
+     * @param out Receives interleaved frames
+     * @param frameCount The maximum number of frames
+     * @return The number of frames read; less than frameCount on underrun or at the end
+     */
+    std::size_t read(float* out, std::size_t frameCount);
+
+    /// The file has been fully decoded and every frame has been read
+    bool isFinished() const;
+    /// Number of times the mixer found the buffer empty before the end of the file
+    std::uint64_t getUnderrunCount() const { return underruns_.load(std::memory_order_relaxed); }
+
+private:
+    struct Decoder;
+
+    StreamingSound(SDL_IOStream* io, const SDL_AudioSpec& spec, std::size_t bufferFrames,
+                   int loops);
+
+    // Decode one MP3 frame into the converter; false at the end of the file
+    bool decodeFrame();
+    bool rewind();
+
+    SDL_IOStream* io_;
+    std::unique_ptr<Decoder> decoder_;
+    SDL_AudioStream* converter_ = nullptr;  // Created from the first frame's format
+    SDL_AudioSpec spec_;
+    SpscRing<float> ring_;
+    std::vector<std::uint8_t> input_;
+    std::size_t inputSize_ = 0;
+    std::size_t inputPosition_ = 0;
+    bool fileEnded_ = false;
+    std::uint64_t framesSinceRewind_ = 0;
+    std::vector<float> scratch_;
+    int loops_;
+    bool decodeEnded_ = false;  // The last pass has been decoded
+    std::atomic<bool> finished_{false};
+    std::atomic<std::uint64_t> underruns_{0};
+};
+
+}  // namespace ast
@@ -1,14 +1,24 @@
 #pragma once
 
+#include <cstdint>
+
+#include "Rect.hpp"
 #include "Vector2.hpp"
 
 class SDL_Texture;
 
 namespace ast {
 
+/// Index of a texture in the Cache, stable for the lifetime of the program
+using TextureId = std::uint32_t;
+
+inline constexpr TextureId NULL_TEXTURE_ID = 0;
+
 struct Texture {
     SDL_Texture* handle = nullptr;
     Vector2 size;
+    // Region of handle holding the image; images packed into an atlas share a handle
+    Rect source;
 };
 
-}  // namespace ast
\ No newline at end of file
+}  // namespace ast
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL_render.h>
+
+#include "Camera.hpp"
+#include "Color.hpp"
+#include "QuadIndices.hpp"
+#include "Rect.hpp"
+#include "Texture.hpp"
+#include "Vector2.hpp"
+
+namespace ast {
+
+/**
+ * A grid of tiles drawn from a tileset texture.
+ * The map is split into square chunks. Each chunk keeps the local positions and texture
+ * coordinates of its tiles and rebuilds them only after one of its tiles changed, so a
+ * static map does no per-tile lookups. Chunks outside the view are culled; every draw
+ * copies the cached vertices of the visible ones, offset and scaled for the view, into
+ * one array drawn with a single SDL_RenderGeometry() call.
+ * Tile n shows the nth cell of the tileset, counting from 1 in rows from the top left;
+ * EMPTY_TILE draws nothing. If the tileset cannot be loaded, tiles are drawn as solid
+ * rectangles of the tint color.
+ * Not pipeline safe: draw() reads tiles that setTile() writes and rebuilds chunks, so
+ * only call it from render() while the Engine is not pipelined, or stop editing the map
+ * from update() first.
+ */
+class Tilemap {
+public:
+    using Tile = std::uint16_t;
+
+    static constexpr Tile EMPTY_TILE = 0;
+
+    struct Stats {
+        std::size_t chunks = 0;
+        std::size_t visibleChunks = 0;
+        std::size_t rebuiltChunks = 0;  // Chunks whose vertices were rebuilt in the last draw
+        std::size_t tiles = 0;          // Non-empty tiles drawn
+    };
+
+    /**
+     * Create an empty map.
+     * @param columns The width of the map in tiles
+     * @param rows The height of the map in tiles
+     * @param tileset The texture holding the tiles
+     * @param tileSize The size of a tile, in tileset pixels and world units
+     * @param chunkSize The width and height of a chunk in tiles
+     */
+    Tilemap(int columns, int rows, TextureId tileset, int tileSize, int chunkSize = 32);
+
+    int getColumns() const { return columns_; }
+    int getRows() const { return rows_; }
+    int getTileSize() const { return tileSize_; }
+
+    Tile getTile(int column, int row) const;
+    /// Set a tile, marking its chunk for rebuilding. Tiles outside the map are ignored.
+    void setTile(int column, int row, Tile tile);
+    void fill(Tile tile);
+
+    /// Position of the top-left corner of the map in the world
+    void setPosition(Vector2 position);
+    Vector2 getPosition() const { return position_; }
+    /// The area covered by the map in the world
+    Rect getBounds() const;
+
+    void setTint(Color tint);
+
+    /**
+     * Draw the part of the map in view of a camera.
+     * @param renderer The renderer
+     * @param camera The camera; the map's position is in its world coordinates
+     */
+    void draw(SDL_Renderer* renderer, const Camera& camera);
+
+    /**
+     * Draw the part of the map inside an area of the render target.
+     * @param renderer The renderer
+     * @param view The area in render coordinates, e.g. the logical presentation size
+     */
+    void draw(SDL_Renderer* renderer, const Rect& view);
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Chunk {
+        // Vertices of the non-empty tiles relative to the map's top-left corner, four per
+        // tile; colors are applied when drawn
+        std::vector<SDL_Vertex> vertices;
+        bool dirty = true;
+    };
+
+    void draw(SDL_Renderer* renderer, const Rect& view, const Camera* camera);
+    void rebuild(int chunkColumn, int chunkRow, const Texture& tileset, Vector2 textureSize);
+    void markAllDirty();
+
+    int columns_;
+    int rows_;
+    int tileSize_;
+    int chunkSize_;
+    int chunkColumns_;
+    int chunkRows_;
+    TextureId tilesetId_;
+    Vector2 position_;
+    Color tint_ = Color::WHITE;
+    std::vector<Tile> tiles_;
+    std::vector<Chunk> chunks_;
+    std::vector<Rect> chunkBounds_;  // In the world, matching chunks_
+    // The tileset the chunk vertices were built for; a change rebuilds every chunk
+    SDL_Texture* builtHandle_ = nullptr;
+    Rect builtSource_;
+
+    // Reused across draws
+    std::vector<std::uint32_t> visibleChunks_;
+    std::vector<SDL_Vertex> vertices_;
+    QuadIndices indices_;
+    Stats stats_;
+};
+
+}  // namespace ast
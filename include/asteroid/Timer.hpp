@@ -1,19 +1,107 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <queue>
+#include <functional>
+#include <vector>
 
 namespace ast {
 
 class Timer {
 public:
+    /// How endFrame() waits for the next frame
+    enum class Pacing {
+        // Sleep until the deadline, waking early by the measured oversleep; uses no CPU
+        // while waiting. The default.
+        Sleep,
+        // Sleep, then busy-wait to hit the deadline exactly. The wait spins for about the
+        // measured oversleep plus the spin threshold, occupying a core every frame.
+        SleepAndSpin,
+        // Do not wait; the renderer's vsync paces the frames
+        VSync,
+        // Do not wait at all
+        Uncapped,
+    };
+
+    struct PacingStats {
+        std::uint64_t frames = 0;  // Frames that waited
+        // Distance between the wake-up and the deadline, in seconds
+        double meanError = 0.0;
+        double maxError = 0.0;
+        double sleepTime = 0.0;
+        double spinTime = 0.0;  // Time spent busy-waiting, during which a core is occupied
+    };
+
+    /// Frame time distribution over the last FRAME_HISTORY_SIZE frames, in seconds
+    struct FrameStats {
+        std::size_t frames = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    using HitchCallback = std::function<void(double frameTime)>;
+
+    static constexpr std::size_t FRAME_HISTORY_SIZE = 512;
+
     explicit Timer(int targetFps = 60);
     void startFrame();
+    /// Wait until the frame has lasted 1 / target FPS seconds, according to the pacing
     void endFrame();
+
+    Pacing getPacing() const { return pacing_; }
+    void setPacing(Pacing pacing) { pacing_ = pacing; }
+
+    /**
+     * Set how long before the deadline SleepAndSpin pacing stops sleeping, in addition to
+     * the measured oversleep. Larger values are more precise on systems with a coarse
+     * sleep but cost more CPU.
+     * @param seconds The threshold
+     */
+    void setSpinThreshold(double seconds) { spinThreshold_ = seconds; }
+    double getSpinThreshold() const { return spinThreshold_; }
+
+    const PacingStats& getPacingStats() const { return pacingStats_; }
+    void resetPacingStats() {
+        pacingStats_ = {};
+        errorSum_ = 0.0;
+    }
     int getTargetFps() const { return targetFps_; }
-    void setTargetFps(int targetFps) { targetFps_ = targetFps; }
+    void setTargetFps(int targetFps) {
+        targetFps_ = targetFps;
+        targetFrameSec_ = 1.0 / targetFps;
+    }
     double getFps() const { return averageFps_; }
     double getDeltaTime() const;
+    /// Unsmoothed duration of the last frame in seconds
+    double getFrameTime() const { return lastFrameSec_; }
+
+    /// Percentiles of the recent frame times; sorts a copy of the history
+    FrameStats getFrameStats() const;
+
+    /**
+     * Count the recent frame times by duration.
+     * @param bucketCount The number of buckets
+     * @param bucketWidth The duration covered by each bucket in seconds; the last bucket
+     * also counts every longer frame
+     * @return The number of frames in each bucket
+     */
+    std::vector<std::size_t> getHistogram(std::size_t bucketCount, double bucketWidth) const;
+
+    /**
+     * Report frames that take longer than a threshold.
+     * @param seconds The threshold, 0 to disable
+     * @param callback Called from startFrame() with the duration of each hitch, may be empty
+     */
+    void setHitchThreshold(double seconds, HitchCallback callback = {});
+    double getHitchThreshold() const { return hitchThreshold_; }
+    /// Number of hitches since the last reset()
+    std::uint64_t getHitchCount() const { return hitchCount_; }
+
+    /// Restart timing and clear the frame history, hitch count and pacing stats
     void reset();
 
     static double getClockTime();
@@ -22,20 +110,30 @@ public:
 
 private:
     inline static double initTime_{};
-    static constexpr size_t frameSecSamples_s = 100;
 
-    std::queue<double> frameSecHistory_;
+    // Ring buffer of the latest frame times
+    std::array<double, FRAME_HISTORY_SIZE> frameHistory_{};
+    std::size_t historyCount_{};
+    std::size_t historyIndex_{};
+    double hitchThreshold_ = 0.1;
+    HitchCallback hitchCallback_;
+    std::uint64_t hitchCount_{};
     uint64_t startFrameTime_{};
     uint64_t previousFrameTime_{};
     uint64_t lastFpsUpdateTime_{};
     double targetFrameSec_{};
     double frameSecSum_{};
     double smoothedFrameSec_{};
+    double lastFrameSec_{};
     double averageFps_{};
-    double sleepError_{};
+    // Average time a sleep lasts beyond what was requested
+    double oversleep_{};
+    double spinThreshold_ = 0.001;
+    double errorSum_{};
+    PacingStats pacingStats_;
+    Pacing pacing_ = Pacing::Sleep;
     int targetFps_;
     int frames_{};
-    int frameSecIndex_{};
 };
 
 }  // namespace ast
@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "../Profiler.hpp"
 #include "Component.hpp"
 #include "Entity.hpp"
 #include "SparseSet.hpp"
@@ -173,6 +174,7 @@ public:
         }
         systems_.push_back(std::make_unique<T>(std::forward<Args>(args)...));
         T& system = static_cast<T&>(*systems_.back());
+        system.profileName_ = Profiler::getTypeName(typeid(T));
         for (const auto& [entity, signature] : entitySignatures_) {
             if ((signature & system.getSignature()) == system.getSignature()) {
                 system.addEntity(entity);
@@ -243,6 +245,7 @@ public:
     // Update all systems
     void update(float dt) {
         for (auto& system : systems_) {
+            AST_PROFILE_ZONE(system->getProfileName());
             system->update(dt);
         }
         // Clean up expired entities
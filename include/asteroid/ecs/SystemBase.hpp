@@ -65,12 +65,18 @@ public:
     Registry& getRegistry() { return registry_; }
     const Registry& getRegistry() const { return registry_; }
 
+    /// The name of the system in profiler zones, resolved once when it is attached
+    const char* getProfileName() const { return profileName_; }
+
 protected:
     std::vector<Entity> entities_;
     Registry& registry_;
     Signature signature_;
 
 private:
+    friend Registry;
+
+    const char* profileName_ = "System";
     inline static TypeId s_typeId = 0;
 };
 
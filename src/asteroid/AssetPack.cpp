@@ -0,0 +1,347 @@
+#include "asteroid/AssetPack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "asteroid/Hash.hpp"
+
+namespace ast {
+
+namespace {
+
+// Packs stay mapped once opened so that lookups from Cache and Audio share one mapping
+std::mutex s_packsMutex;
+std::unordered_map<std::string, std::shared_ptr<const AssetPack>> s_packs;
+
+std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Reads an asset in place; holding the asset keeps its pack mapped until SDL closes the
+// stream, even if the pack is dropped from the cache in the meantime
+struct AssetStream {
+    AssetPack::Asset asset;
+    std::size_t position = 0;
+};
+
+Sint64 SDLCALL assetStreamSize(void* userdata) {
+    return static_cast<Sint64>(static_cast<AssetStream*>(userdata)->asset.size);
+}
+
+Sint64 SDLCALL assetStreamSeek(void* userdata, Sint64 offset, SDL_IOWhence whence) {
+    auto& stream = *static_cast<AssetStream*>(userdata);
+    const auto size = static_cast<Sint64>(stream.asset.size);
+    Sint64 base = 0;
+    if (whence == SDL_IO_SEEK_CUR) {
+        base = static_cast<Sint64>(stream.position);
+    } else if (whence == SDL_IO_SEEK_END) {
+        base = size;
+    }
+    if (base + offset < 0) {
+        SDL_SetError("Seek before the start of an asset");
+        return -1;
+    }
+    stream.position = static_cast<std::size_t>(std::min(base + offset, size));
+    return static_cast<Sint64>(stream.position);
+}
+
+std::size_t SDLCALL assetStreamRead(void* userdata, void* ptr, std::size_t size,
+                                    SDL_IOStatus* status) {
+    auto& stream = *static_cast<AssetStream*>(userdata);
+    const std::size_t count = std::min(size, stream.asset.size - stream.position);
+    if (count == 0 && size > 0) {
+        *status = SDL_IO_STATUS_EOF;
+        return 0;
+    }
+    std::memcpy(ptr, stream.asset.data + stream.position, count);
+    stream.position += count;
+    return count;
+}
+
+bool SDLCALL assetStreamClose(void* userdata) {
+    delete static_cast<AssetStream*>(userdata);
+    return true;
+}
+
+SDL_IOStream* openAssetStream(AssetPack::Asset asset) {
+    static const SDL_IOStreamInterface streamInterface = [] {
+        SDL_IOStreamInterface result;
+        SDL_INIT_INTERFACE(&result);
+        result.size = assetStreamSize;
+        result.seek = assetStreamSeek;
+        result.read = assetStreamRead;
+        result.close = assetStreamClose;
+        return result;
+    }();
+    auto* stream = new AssetStream{std::move(asset)};
+    SDL_IOStream* io = SDL_OpenIO(&streamInterface, stream);
+    if (!io) {
+        delete stream;
+    }
+    return io;
+}
+
+}  // namespace
+
+AssetPack::AssetPack(std::filesystem::path path) : path_(std::move(path)) {}
+
+AssetPack::~AssetPack() { unmap(); }
+
+std::shared_ptr<const AssetPack> AssetPack::open(const std::filesystem::path& file) {
+    std::string key = file.lexically_normal().string();
+    std::lock_guard<std::mutex> lock(s_packsMutex);
+    if (auto it = s_packs.find(key); it != s_packs.end()) {
+        return it->second;
+    }
+    std::shared_ptr<AssetPack> pack(new AssetPack(file));
+    if (!pack->map()) {
+        return nullptr;
+    }
+    AST_INFO("Mapped asset pack {} ({} entries, {} bytes)", key, pack->getEntryCount(),
+             pack->size_);
+    s_packs.emplace(std::move(key), pack);
+    return pack;
+}
+
+std::optional<AssetPack::Asset> AssetPack::resolve(const std::filesystem::path& path) {
+    std::filesystem::path normal = path.lexically_normal();
+    for (std::filesystem::path parent = normal.parent_path(); !parent.empty();
+         parent = parent.parent_path()) {
+        std::error_code error;
+        if (std::filesystem::is_regular_file(parent, error)) {
+            auto pack = open(parent);
+            if (!pack) {
+                return std::nullopt;
+            }
+            std::string name = normal.lexically_relative(parent).generic_string();
+            const IndexEntry* entry = pack->find(name);
+            if (!entry) {
+                return std::nullopt;
+            }
+            const std::uint8_t* data = pack->getData(*entry);
+            return Asset{std::move(pack), data, static_cast<std::size_t>(entry->size)};
+        }
+        if (parent == parent.parent_path()) {
+            break;
+        }
+    }
+    return std::nullopt;
+}
+
+SDL_IOStream* AssetPack::openIO(const std::filesystem::path& path) {
+    std::error_code error;
+    if (std::filesystem::is_regular_file(path, error)) {
+        return SDL_IOFromFile(path.string().c_str(), "rb");
+    }
+    if (auto asset = resolve(path)) {
+        return openAssetStream(std::move(*asset));
+    }
+    SDL_SetError("Asset not found: %s", path.string().c_str());
+    return nullptr;
+}
+
+void AssetPack::closeAll() {
+    std::lock_guard<std::mutex> lock(s_packsMutex);
+    for (auto it = s_packs.begin(); it != s_packs.end();) {
+        if (it->second.use_count() == 1) {
+            it = s_packs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+const AssetPack::IndexEntry* AssetPack::find(std::string_view name) const {
+    const IndexEntry* end = index_ + header_->entryCount;
+    std::uint64_t hash = hashString(name);
+    auto it = std::lower_bound(index_, end, hash, [](const IndexEntry& entry, std::uint64_t h) {
+        return entry.nameHash < h;
+    });
+    for (; it != end && it->nameHash == hash; ++it) {
+        if (getName(*it) == name) {
+            if (it->offset + it->size > size_) {
+                AST_ERROR("Asset pack {} entry '{}' is out of bounds", path_.string(), name);
+                return nullptr;
+            }
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view AssetPack::getName(const IndexEntry& entry) const {
+    std::uint64_t offset = header_->namesOffset + entry.nameOffset;
+    if (offset + entry.nameLength > size_) {
+        return {};
+    }
+    return {reinterpret_cast<const char*>(data_ + offset), entry.nameLength};
+}
+
+bool AssetPack::map() {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        AST_ERROR("Cannot open asset pack {}", path_.string());
+        return false;
+    }
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(file, &fileSize);
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+    HANDLE mapping =
+        size_ > 0 ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (!mapping) {
+        AST_ERROR("Cannot map asset pack {}", path_.string());
+        return false;
+    }
+    // The view keeps the mapping alive
+    data_ = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+#else
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        AST_ERROR("Cannot open asset pack {}", path_.string());
+        return false;
+    }
+    struct stat info {};
+    fstat(fd, &info);
+    size_ = static_cast<std::size_t>(info.st_size);
+    void* address = size_ > 0 ? mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    // The mapping keeps the file alive
+    ::close(fd);
+    data_ = address != MAP_FAILED ? static_cast<const std::uint8_t*>(address) : nullptr;
+#endif
+    if (!data_) {
+        AST_ERROR("Cannot map asset pack {}", path_.string());
+        size_ = 0;
+        return false;
+    }
+
+    header_ = reinterpret_cast<const Header*>(data_);
+    if (size_ < sizeof(Header) || std::memcmp(header_->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header_->version != VERSION ||
+        header_->indexOffset + std::uint64_t{header_->entryCount} * sizeof(IndexEntry) > size_ ||
+        header_->namesOffset > size_) {
+        AST_ERROR("{} is not a valid asset pack", path_.string());
+        unmap();
+        return false;
+    }
+    index_ = reinterpret_cast<const IndexEntry*>(data_ + header_->indexOffset);
+    return true;
+}
+
+void AssetPack::unmap() {
+    if (!data_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+    index_ = nullptr;
+}
+
+bool AssetPack::write(const std::filesystem::path& directory, const std::filesystem::path& file) {
+    struct Source {
+        std::string name;
+        std::filesystem::path path;
+        std::uint64_t hash;
+        std::uint64_t size;
+    };
+
+    std::error_code error;
+    std::vector<Source> sources;
+    const auto output = std::filesystem::weakly_canonical(file, error);
+    for (const auto& item : std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (!item.is_regular_file() ||
+            std::filesystem::weakly_canonical(item.path(), error) == output) {
+            continue;
+        }
+        std::string name = item.path().lexically_relative(directory).generic_string();
+        std::uint64_t hash = hashString(name);
+        sources.push_back({std::move(name), item.path(), hash, item.file_size()});
+    }
+    if (error) {
+        AST_ERROR("Cannot read {}: {}", directory.string(), error.message());
+        return false;
+    }
+    std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.name < b.name;
+    });
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entryCount = static_cast<std::uint32_t>(sources.size());
+    header.alignment = ALIGNMENT;
+    header.indexOffset = sizeof(Header);
+    header.namesOffset = header.indexOffset + sources.size() * sizeof(IndexEntry);
+
+    std::vector<IndexEntry> index;
+    std::string names;
+    std::uint64_t namesSize = 0;
+    for (const auto& source : sources) {
+        namesSize += source.name.size();
+    }
+    std::uint64_t offset = header.namesOffset + namesSize;
+    for (const auto& source : sources) {
+        offset = alignUp(offset, ALIGNMENT);
+        index.push_back({source.hash, offset, source.size,
+                         static_cast<std::uint32_t>(names.size()),
+                         static_cast<std::uint32_t>(source.name.size())});
+        names += source.name;
+        offset += source.size;
+    }
+
+    std::ofstream out(file, std::ios::binary);
+    if (!out) {
+        AST_ERROR("Cannot write asset pack {}", file.string());
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(IndexEntry));
+    out.write(names.data(), names.size());
+
+    std::vector<char> buffer;
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        const auto position = static_cast<std::uint64_t>(out.tellp());
+        static constexpr char zeros[ALIGNMENT] = {};
+        out.write(zeros, index[i].offset - position);
+
+        std::ifstream in(sources[i].path, std::ios::binary);
+        buffer.resize(sources[i].size);
+        if (!in.read(buffer.data(), buffer.size())) {
+            AST_ERROR("Cannot read {}", sources[i].path.string());
+            return false;
+        }
+        out.write(buffer.data(), buffer.size());
+    }
+    if (!out) {
+        AST_ERROR("Failed writing asset pack {}", file.string());
+        return false;
+    }
+    AST_INFO("Wrote {} assets to {}", sources.size(), file.string());
+    return true;
+}
+
+}  // namespace ast
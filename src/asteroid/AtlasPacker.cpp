@@ -0,0 +1,97 @@
+#include "asteroid/AtlasPacker.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace ast {
+
+AtlasPacker::AtlasPacker(int width, int height) : width_(width), height_(height) { reset(); }
+
+void AtlasPacker::reset() {
+    skyline_.clear();
+    skyline_.push_back({0, 0, width_});
+    usedArea_ = 0;
+}
+
+float AtlasPacker::getOccupancy() const {
+    return static_cast<float>(usedArea_) / (static_cast<float>(width_) * height_);
+}
+
+int AtlasPacker::fit(std::size_t index, int width, int height) const {
+    int x = skyline_[index].x;
+    if (x + width > width_) {
+        return -1;
+    }
+    int y = 0;
+    int remaining = width;
+    // The segments always span the whole page, so this cannot run past the end
+    for (std::size_t i = index; remaining > 0; ++i) {
+        y = std::max(y, skyline_[i].y);
+        if (y + height > height_) {
+            return -1;
+        }
+        remaining -= skyline_[i].width;
+    }
+    return y;
+}
+
+std::optional<AtlasPacker::Placement> AtlasPacker::pack(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return std::nullopt;
+    }
+
+    // Pick the segment that keeps the skyline lowest, ties broken by the narrowest segment
+    std::size_t bestIndex = skyline_.size();
+    int bestBottom = std::numeric_limits<int>::max();
+    int bestWidth = std::numeric_limits<int>::max();
+    int bestY = 0;
+    for (std::size_t i = 0; i < skyline_.size(); ++i) {
+        int y = fit(i, width, height);
+        if (y < 0) {
+            continue;
+        }
+        if (y + height < bestBottom ||
+            (y + height == bestBottom && skyline_[i].width < bestWidth)) {
+            bestIndex = i;
+            bestBottom = y + height;
+            bestWidth = skyline_[i].width;
+            bestY = y;
+        }
+    }
+    if (bestIndex == skyline_.size()) {
+        return std::nullopt;
+    }
+
+    Placement placement{skyline_[bestIndex].x, bestY};
+    skyline_.insert(skyline_.begin() + bestIndex, Segment{placement.x, bestY + height, width});
+
+    // Trim the segments now covered by the new one
+    for (std::size_t i = bestIndex + 1; i < skyline_.size();) {
+        const Segment& previous = skyline_[i - 1];
+        int overlap = previous.x + previous.width - skyline_[i].x;
+        if (overlap <= 0) {
+            break;
+        }
+        skyline_[i].x += overlap;
+        skyline_[i].width -= overlap;
+        if (skyline_[i].width > 0) {
+            break;
+        }
+        skyline_.erase(skyline_.begin() + i);
+    }
+
+    // Merge neighbours at the same height
+    for (std::size_t i = 0; i + 1 < skyline_.size();) {
+        if (skyline_[i].y == skyline_[i + 1].y) {
+            skyline_[i].width += skyline_[i + 1].width;
+            skyline_.erase(skyline_.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+
+    usedArea_ += static_cast<long long>(width) * height;
+    return placement;
+}
+
+}  // namespace ast
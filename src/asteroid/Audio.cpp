@@ -4,6 +4,12 @@
 #define MINIMP3_IMPLEMENTATION
 #include "minimp3.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include "asteroid/AssetPack.hpp"
+
 namespace ast {
 
 Audio& Audio::getInstance() {
@@ -11,6 +17,59 @@ Audio& Audio::getInstance() {
     return instance;
 }
 
+namespace {
+
+// Frames mixed per chunk pushed to the device stream
+constexpr std::size_t MIX_FRAMES = AudioMixer::MIX_FRAMES;
+// Decoded audio kept ahead of playback for streamed sounds
+constexpr double STREAM_BUFFER_SECONDS = 0.25;
+
+bool isMp3(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return extension == ".mp3";
+}
+
+// Decode a whole MP3 file to 16-bit PCM; buffer is allocated with SDL_malloc
+bool loadMp3(SDL_IOStream* io, SDL_AudioSpec* spec, Uint8** buffer, Uint32* length) {
+    std::size_t size = 0;
+    auto* data = static_cast<const Uint8*>(SDL_LoadFile_IO(io, &size, true));
+    if (!data) {
+        return false;
+    }
+    mp3dec_t decoder;
+    mp3dec_init(&decoder);
+    std::vector<mp3d_sample_t> pcm;
+    mp3d_sample_t frame[MINIMP3_MAX_SAMPLES_PER_FRAME];
+    mp3dec_frame_info_t info{};
+    for (std::size_t offset = 0; offset < size;) {
+        int samples = mp3dec_decode_frame(&decoder, data + offset, static_cast<int>(size - offset),
+                                          frame, &info);
+        if (info.frame_bytes == 0) {
+            break;
+        }
+        offset += info.frame_bytes;
+        if (samples > 0) {
+            if (pcm.empty()) {
+                *spec = {SDL_AUDIO_S16, info.channels, info.hz};
+            }
+            pcm.insert(pcm.end(), frame, frame + samples * info.channels);
+        }
+    }
+    SDL_free(const_cast<Uint8*>(data));
+    if (pcm.empty()) {
+        SDL_SetError("No MP3 frames found");
+        return false;
+    }
+    *length = static_cast<Uint32>(pcm.size() * sizeof(mp3d_sample_t));
+    *buffer = static_cast<Uint8*>(SDL_malloc(*length));
+    std::memcpy(*buffer, pcm.data(), *length);
+    return true;
+}
+
+}  // namespace
+
 bool Audio::init() {
     if (initialized_) {
         AST_WARN("Audio already initialized");
@@ -21,31 +80,96 @@ bool Audio::init() {
         SDL_ERROR();
         return false;
     }
+    // The device buffer size is only a hint and must be set before the device is opened
+    SDL_AudioSpec defaultSpec;
+    if (SDL_GetAudioDeviceFormat(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &defaultSpec, nullptr)) {
+        int frames = std::max(64, static_cast<int>(targetLatency_ * defaultSpec.freq));
+        SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, std::to_string(frames).c_str());
+    }
     device_ = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, nullptr);
     if (!device_) {
         SDL_ERROR();
         return false;
     }
-    initialized_ = true;
+    SDL_AudioSpec deviceSpec;
+    SDL_GetAudioDeviceFormat(device_, &deviceSpec, &deviceFrames_);
+    spec_ = {SDL_AUDIO_F32, deviceSpec.channels, deviceSpec.freq};
+    stream_ = SDL_CreateAudioStream(&spec_, &deviceSpec);
+    if (!stream_ || !SDL_SetAudioStreamGetCallback(stream_, &Audio::feedStream, this) ||
+        !SDL_BindAudioStream(device_, stream_)) {
+        SDL_ERROR();
+        SDL_DestroyAudioStream(stream_);
+        stream_ = nullptr;
+        SDL_CloseAudioDevice(device_);
+        device_ = 0;
+        return false;
+    }
+    AST_INFO("Mixing {} channels at {} Hz, latency {:.1f} ms", spec_.channels, spec_.freq,
+             getLatency() * 1000.0);
+    start(spec_.channels, spec_.freq);
     return true;
 }
 
+bool Audio::initOffline(int channels, int sampleRate) {
+    if (initialized_) {
+        AST_WARN("Audio already initialized");
+        return true;
+    }
+    if (channels <= 0 || sampleRate <= 0) {
+        AST_ERROR("Invalid offline audio format: {} channels at {} Hz", channels, sampleRate);
+        return false;
+    }
+    AST_INFO("Initializing offline Audio, {} channels at {} Hz", channels, sampleRate);
+    deviceFrames_ = 0;
+    offlineGain_ = 1.0f;
+    start(channels, sampleRate);
+    return true;
+}
+
+void Audio::start(int channels, int sampleRate) {
+    spec_ = {SDL_AUDIO_F32, channels, sampleRate};
+    mixer_ = AudioMixer(channels, mixer_.getStats().maxVoices);
+    mixBuffer_.resize(MIX_FRAMES * channels);
+    stopDecoder_ = false;
+    decoderThread_ = std::thread(&Audio::decoderLoop, this);
+    initialized_ = true;
+}
+
 void Audio::shutdown() {
     if (!initialized_) {
         AST_WARN("Audio not initialized, nothing to shutdown");
         return;
     }
-    for (auto& [name, data] : sounds_) {
-        SDL_free(data.buffer);
-        SDL_DestroyAudioStream(data.stream);
+    // Stops the callback, after which the mixer belongs to this thread again
+    SDL_DestroyAudioStream(stream_);
+    stream_ = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(streamsMutex_);
+        stopDecoder_ = true;
     }
+    streamsChanged_.notify_one();
+    decoderThread_.join();
+    streams_.clear();
+
+    Command command;
+    while (commands_.pop(command)) {
+    }
+    command = {};
+    VoiceId voice;
+    while (endedVoices_.pop(voice)) {
+    }
+    endedVoicesLost_ = false;
+    voices_.clear();
+    mixer_.stopAll();
+    mixer_.clearEndedVoices();
     sounds_.clear();
-    playing_.clear();
+    samples_.clear();
+    residentBytes_ = 0;
     if (device_) {
         SDL_CloseAudioDevice(device_);
         device_ = 0;
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
     }
-    SDL_QuitSubSystem(SDL_INIT_AUDIO);
     initialized_ = false;
 }
 
@@ -58,46 +182,105 @@ bool Audio::loadSound(const std::string& name, const std::filesystem::path& file
         AST_WARN("Sound '{}' already loaded", name);
         return true;
     }
-
-    AudioData data;
-    if (!SDL_LoadWAV(filePath.string().c_str(), &data.spec, &data.buffer, &data.length)) {
-        SDL_ERROR();
+    if (!acquireSample(filePath)) {
         return false;
     }
-    SDL_AudioSpec deviceSpec;
-    SDL_GetAudioDeviceFormat(device_, &deviceSpec, nullptr);
-    data.stream = SDL_CreateAudioStream(&data.spec, &deviceSpec);
-    if (!data.stream) {
-        SDL_ERROR();
-        SDL_free(data.buffer);
+    sounds_.emplace(name, Sound{filePath});
+    return true;
+}
+
+bool Audio::loadStream(const std::string& name, const std::filesystem::path& filePath) {
+    if (!initialized_) {
+        AST_WARN("Audio not initialized, cannot load sound '{}'", name);
         return false;
     }
-    // Bind the stream to the device
-    if (!SDL_BindAudioStream(device_, data.stream)) {
+    if (sounds_.find(name) != sounds_.end()) {
+        AST_WARN("Sound '{}' already loaded", name);
+        return true;
+    }
+    if (!isMp3(filePath)) {
+        AST_WARN("Only MP3 files can be streamed, loading {} instead", filePath.string());
+        return loadSound(name, filePath);
+    }
+    // Check that the file can be opened now rather than on every play
+    SDL_IOStream* io = AssetPack::openIO(filePath);
+    if (!io) {
         SDL_ERROR();
-        SDL_free(data.buffer);
-        SDL_DestroyAudioStream(data.stream);
         return false;
     }
+    SDL_CloseIO(io);
 
-    AST_INFO("Loaded sound '{}' from {} (length: {} bytes)", name, filePath.string(), data.length);
-    sounds_.emplace(name, std::move(data));
+    AST_INFO("Streaming sound '{}' from {}", name, filePath.string());
+    sounds_.emplace(name, Sound{.path = filePath, .streamed = true});
     return true;
 }
 
-void Audio::playSound(const std::string& name, int loops) {
+VoiceId Audio::playSound(const std::string& name, int loops) {
+    VoiceParams params;
+    params.loops = loops;
+    return playSound(name, params);
+}
+
+VoiceId Audio::playSound(const std::string& name, const VoiceParams& params) {
     if (!initialized_) {
         AST_WARN("Audio not initialized, cannot play sound '{}'", name);
-        return;
+        return NULL_VOICE_ID;
     }
-    if (sounds_.find(name) == sounds_.end()) {
-        if (!loadSound(name, assetsDirectory_ / name)) {
-            return;
+    // Loading on first play keeps the sample, so the cache counts one lookup per play
+    std::shared_ptr<const AudioSample> sample;
+    auto it = sounds_.find(name);
+    if (it == sounds_.end()) {
+        std::filesystem::path filePath = assetsDirectory_ / name;
+        sample = acquireSample(filePath);
+        if (!sample) {
+            return NULL_VOICE_ID;
         }
+        it = sounds_.emplace(name, Sound{std::move(filePath)}).first;
     }
 
-    AST_INFO("Playing sound '{}'", name);
-    playing_[name] = loops;
+    const Sound& sound = it->second;
+    VoiceParams voiceParams = params;
+    voiceParams.gain *= sound.gain;
+    VoiceId voice = nextVoiceId_++;
+    Command command;
+    if (!sound.streamed) {
+        if (!sample) {
+            sample = acquireSample(sound.path);
+        }
+        if (!sample) {
+            return NULL_VOICE_ID;
+        }
+        command = {.type = Command::Type::Play,
+                   .voice = voice,
+                   .source = &sound,
+                   .params = voiceParams,
+                   .sample = std::move(sample)};
+    } else {
+        auto bufferFrames = static_cast<std::size_t>(spec_.freq * STREAM_BUFFER_SECONDS);
+        auto stream = StreamingSound::open(sound.path, spec_, bufferFrames, params.loops);
+        if (!stream) {
+            return NULL_VOICE_ID;
+        }
+        {
+            std::lock_guard<std::mutex> lock(streamsMutex_);
+            streams_.push_back(stream);
+        }
+        streamsChanged_.notify_one();
+        command = {.type = Command::Type::PlayStream,
+                   .voice = voice,
+                   .source = &sound,
+                   .params = voiceParams,
+                   .stream = std::move(stream)};
+    }
+    // Track the voice before submitting: without a device the command runs right away and
+    // a voice the mixer rejects is reported as ended during submit()
+    voices_.emplace(voice, &sound);
+    if (!submit(std::move(command))) {
+        voices_.erase(voice);
+        return NULL_VOICE_ID;
+    }
+    AST_DEBUG("Playing sound '{}' on voice {}", name, voice);
+    return voice;
 }
 
 void Audio::stopSound(const std::string& name) {
@@ -105,22 +288,33 @@ void Audio::stopSound(const std::string& name) {
         AST_WARN("Audio not initialized, cannot stop sound '{}'", name);
         return;
     }
-    auto it = playing_.find(name);
-    if (it != playing_.end()) {
+    if (isSoundPlaying(name)) {
         AST_INFO("Stopping sound '{}'", name);
-        playing_.erase(it);
-        sounds_[name].currentPosition = 0;
+        const void* source = &sounds_.at(name);
+        submit({.type = Command::Type::StopSource, .source = source});
+        std::erase_if(voices_, [source](const auto& voice) { return voice.second == source; });
     } else {
         AST_WARN("Sound '{}' not playing", name);
     }
 }
 
+void Audio::stopVoice(VoiceId voice) {
+    if (voices_.erase(voice) > 0) {
+        submit({.type = Command::Type::Stop, .voice = voice});
+    }
+}
+
+void Audio::stopAll() {
+    voices_.clear();
+    submit({.type = Command::Type::StopAll});
+}
+
 float Audio::getMasterGain() const {
     if (!initialized_) {
         AST_WARN("Audio not initialized, cannot get gain");
         return -1.0f;
     }
-    return SDL_GetAudioDeviceGain(device_);
+    return device_ ? SDL_GetAudioDeviceGain(device_) : offlineGain_;
 }
 
 void Audio::setMasterGain(float gain) {
@@ -129,64 +323,362 @@ void Audio::setMasterGain(float gain) {
         return;
     }
     AST_INFO("Setting master gain to {}", gain);
-    SDL_SetAudioDeviceGain(device_, gain);
+    if (device_) {
+        SDL_SetAudioDeviceGain(device_, gain);
+    } else {
+        offlineGain_ = gain;
+    }
 }
 
 float Audio::getSoundGain(const std::string& name) const {
     auto it = sounds_.find(name);
     if (it != sounds_.end()) {
-        return SDL_GetAudioStreamGain(it->second.stream);
+        return it->second.gain;
     }
     AST_WARN("Sound '{}' not found", name);
-    return -1.0f;  // SDL_GetAudioStreamGain() returns -1.0f on error
+    return -1.0f;
 }
 
 void Audio::setSoundGain(const std::string& name, float gain) {
     auto it = sounds_.find(name);
     if (it != sounds_.end()) {
-        SDL_SetAudioStreamGain(it->second.stream, gain);
+        it->second.gain = gain;
         AST_INFO("Set gain for sound '{}' to {}", name, gain);
     } else {
         AST_WARN("Sound '{}' not found", name);
     }
 }
 
+void Audio::setVoiceGain(VoiceId voice, float gain) {
+    submit({.type = Command::Type::SetGain,
+            .voice = voice,
+            .value = gain * getVoiceSoundGain(voice)});
+}
+
+void Audio::setVoicePitch(VoiceId voice, float pitch) {
+    submit({.type = Command::Type::SetPitch, .voice = voice, .value = pitch});
+}
+
+void Audio::setVoicePan(VoiceId voice, float pan) {
+    submit({.type = Command::Type::SetPan, .voice = voice, .pan = pan});
+}
+
+void Audio::updateVoices(const std::vector<VoiceUpdate>& updates) {
+    batch_.clear();
+    for (const VoiceUpdate& update : updates) {
+        batch_.push_back({.type = Command::Type::SetGainAndPan,
+                          .voice = update.voice,
+                          .value = update.gain * getVoiceSoundGain(update.voice),
+                          .pan = update.pan});
+    }
+    if (!stream_) {
+        for (Command& command : batch_) {
+            execute(command);
+        }
+        return;
+    }
+    if (commands_.write(batch_.data(), batch_.size()) < batch_.size()) {
+        AST_WARN("Audio command queue is full, dropped voice updates");
+    }
+}
+
 bool Audio::isSoundPlaying(const std::string& name) const {
-    return playing_.find(name) != playing_.end();
+    auto it = sounds_.find(name);
+    if (it == sounds_.end()) {
+        return false;
+    }
+    const void* source = &it->second;
+    return std::any_of(voices_.begin(), voices_.end(),
+                       [source](const auto& voice) { return voice.second == source; });
+}
+
+bool Audio::isVoicePlaying(VoiceId voice) const { return voices_.count(voice) > 0; }
+
+float Audio::getVoiceSoundGain(VoiceId voice) const {
+    auto it = voices_.find(voice);
+    return it != voices_.end() ? static_cast<const Sound*>(it->second)->gain : 1.0f;
 }
 
 void Audio::setAssetsDirectory(const std::filesystem::path& directory) {
     assetsDirectory_ = directory;
 }
 
+void Audio::setMaxVoices(std::size_t maxVoices) {
+    submit({.type = Command::Type::SetMaxVoices, .count = maxVoices});
+}
+
+AudioMixer::Stats Audio::getMixerStats() const {
+    if (!stream_) {
+        return mixer_.getStats();
+    }
+    // The callback runs with the stream locked
+    SDL_LockAudioStream(stream_);
+    AudioMixer::Stats stats = mixer_.getStats();
+    SDL_UnlockAudioStream(stream_);
+    return stats;
+}
+
+void Audio::setTargetLatency(double seconds) { targetLatency_ = seconds; }
+
+double Audio::getLatency() const {
+    return spec_.freq > 0 ? static_cast<double>(deviceFrames_) / spec_.freq : 0.0;
+}
+
+void Audio::setMemoryBudget(std::size_t bytes) {
+    memoryBudget_ = bytes;
+    evictToBudget();
+}
+
+void Audio::setSampleFormat(SampleFormat format) { sampleFormat_ = format; }
+
+Audio::Stats Audio::getStats() const {
+    return {.residentBytes = residentBytes_,
+            .budgetBytes = memoryBudget_,
+            .sampleCount = samples_.size(),
+            .soundCount = sounds_.size(),
+            .hits = hits_,
+            .misses = misses_,
+            .evictions = evictions_};
+}
+
 void Audio::update() {
-    constexpr Uint32 CHUNK_SIZE = 8192;  // 8KB chunks
-
-    for (auto it = playing_.begin(); it != playing_.end();) {
-        AudioData& data = sounds_[it->first];
-        // Check if we need to feed more data to the stream
-        if (SDL_GetAudioStreamQueued(data.stream) < CHUNK_SIZE) {
-            // Calculate how much data we can feed
-            int bytesToFeed = std::min(CHUNK_SIZE, data.length - data.currentPosition);
-            if (bytesToFeed > 0) {
-                SDL_PutAudioStreamData(data.stream, data.buffer + data.currentPosition,
-                                       bytesToFeed);
-                data.currentPosition += bytesToFeed;
-                ++it;
-            } else {
-                // Finished playing, reset position
-                data.currentPosition = 0;
-                if (it->second != 0 && --it->second == 0) {
-                    // No more loops, remove from playing
-                    it = playing_.erase(it);
-                } else {
-                    ++it;
-                }
-            }
-        } else {
-            ++it;
+    ++frame_;
+    VoiceId voice;
+    while (endedVoices_.pop(voice)) {
+        voices_.erase(voice);
+    }
+    if (endedVoicesLost_.exchange(false, std::memory_order_relaxed)) {
+        resyncVoices();
+    }
+    evictToBudget();
+}
+
+std::shared_ptr<const AudioSample> Audio::acquireSample(const std::filesystem::path& filePath) {
+    std::string key = filePath.lexically_normal().generic_string();
+    if (auto it = samples_.find(key); it != samples_.end()) {
+        ++hits_;
+        it->second.lastUsedFrame = frame_;
+        return it->second.sample;
+    }
+    ++misses_;
+    std::shared_ptr<const AudioSample> sample = decodeSample(filePath);
+    if (!sample) {
+        return nullptr;
+    }
+    std::size_t bytes = sample->getByteSize();
+    samples_.emplace(std::move(key), CachedSample{sample, bytes, frame_});
+    residentBytes_ += bytes;
+    evictToBudget();
+    return sample;
+}
+
+std::shared_ptr<AudioSample> Audio::decodeSample(const std::filesystem::path& filePath) const {
+    SDL_AudioSpec spec;
+    Uint8* buffer = nullptr;
+    Uint32 length = 0;
+    SDL_IOStream* io = AssetPack::openIO(filePath);
+    bool loaded = isMp3(filePath) ? loadMp3(io, &spec, &buffer, &length)
+                                  : SDL_LoadWAV_IO(io, true, &spec, &buffer, &length);
+    if (!loaded) {
+        SDL_ERROR();
+        return nullptr;
+    }
+    // Convert once so that mixing never has to resample or change the layout
+    const bool int16 = sampleFormat_ == SampleFormat::Int16;
+    const SDL_AudioSpec storageSpec{int16 ? SDL_AUDIO_S16 : SDL_AUDIO_F32, spec_.channels,
+                                    spec_.freq};
+    Uint8* converted = nullptr;
+    int convertedLength = 0;
+    bool success = SDL_ConvertAudioSamples(&spec, buffer, static_cast<int>(length), &storageSpec,
+                                           &converted, &convertedLength);
+    SDL_free(buffer);
+    if (!success) {
+        SDL_ERROR();
+        return nullptr;
+    }
+
+    auto sample = std::make_shared<AudioSample>();
+    sample->channels = spec_.channels;
+    sample->frameCount = convertedLength / SDL_AUDIO_FRAMESIZE(storageSpec);
+    const std::size_t count = sample->frameCount * spec_.channels;
+    if (int16) {
+        const auto* data = reinterpret_cast<const std::int16_t*>(converted);
+        sample->data16.assign(data, data + count);
+    } else {
+        const auto* data = reinterpret_cast<const float*>(converted);
+        sample->data.assign(data, data + count);
+    }
+    SDL_free(converted);
+
+    AST_INFO("Loaded sound {} ({} bytes as {})", filePath.string(), sample->getByteSize(),
+             int16 ? "16-bit" : "float");
+    return sample;
+}
+
+void Audio::evictToBudget() {
+    if (memoryBudget_ == 0 || residentBytes_ <= memoryBudget_) {
+        return;
+    }
+    std::vector<std::unordered_map<std::string, CachedSample>::iterator> candidates;
+    for (auto it = samples_.begin(); it != samples_.end(); ++it) {
+        // Voices and queued commands hold their own references
+        if (it->second.sample.use_count() == 1 && it->second.lastUsedFrame < frame_) {
+            candidates.push_back(it);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a->second.lastUsedFrame < b->second.lastUsedFrame;
+    });
+    for (auto it : candidates) {
+        if (residentBytes_ <= memoryBudget_) {
+            break;
+        }
+        AST_DEBUG("Evicting sound {}", it->first);
+        residentBytes_ -= it->second.bytes;
+        samples_.erase(it);
+        ++evictions_;
+    }
+}
+
+void SDLCALL Audio::feedStream(void* userdata, SDL_AudioStream* stream, int additionalAmount,
+                               int totalAmount) {
+    auto& audio = *static_cast<Audio*>(userdata);
+    Command command;
+    while (audio.commands_.pop(command)) {
+        audio.execute(command);
+        // Keeps the mixer's list within the room it reserved
+        audio.forwardEndedVoices();
+    }
+
+    if (audio.mixer_.getActiveVoiceCount() > 0) {
+        const int frameSize = SDL_AUDIO_FRAMESIZE(audio.spec_);
+        int frames = (additionalAmount + frameSize - 1) / frameSize;
+        while (frames > 0) {
+            int count = std::min(frames, static_cast<int>(MIX_FRAMES));
+            audio.mixer_.mix(audio.mixBuffer_.data(), count);
+            SDL_PutAudioStreamData(stream, audio.mixBuffer_.data(), count * frameSize);
+            frames -= count;
+        }
+    }
+
+    audio.forwardEndedVoices();
+}
+
+void Audio::forwardEndedVoices() {
+    for (VoiceId voice : mixer_.getEndedVoices()) {
+        if (!endedVoices_.push(voice)) {
+            endedVoicesLost_.store(true, std::memory_order_relaxed);
+        }
+    }
+    mixer_.clearEndedVoices();
+}
+
+void Audio::resyncVoices() {
+    AST_WARN("Audio ended voice queue overflowed, resynchronizing voices");
+    // With the stream locked the callback cannot run, so this thread may consume its
+    // commands; afterwards the mixer knows about every voice in voices_
+    SDL_LockAudioStream(stream_);
+    Command command;
+    while (commands_.pop(command)) {
+        execute(command);
+    }
+    mixer_.clearEndedVoices();
+    std::erase_if(voices_, [this](const auto& voice) { return !mixer_.isPlaying(voice.first); });
+    SDL_UnlockAudioStream(stream_);
+}
+
+bool Audio::render(float* out, std::size_t frameCount) {
+    if (!isOffline()) {
+        AST_WARN("Audio not initialized offline, cannot render");
+        return false;
+    }
+    mixer_.mix(out, frameCount);
+    if (offlineGain_ != 1.0f) {
+        const std::size_t count = frameCount * spec_.channels;
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] *= offlineGain_;
+        }
+    }
+    collectEndedVoices();
+    return true;
+}
+
+void Audio::collectEndedVoices() {
+    for (VoiceId voice : mixer_.getEndedVoices()) {
+        voices_.erase(voice);
+    }
+    mixer_.clearEndedVoices();
+}
+
+bool Audio::submit(Command command) {
+    if (!stream_) {
+        execute(command);
+        collectEndedVoices();
+        return true;
+    }
+    if (!commands_.push(command)) {
+        AST_WARN("Audio command queue is full");
+        return false;
+    }
+    return true;
+}
+
+void Audio::execute(Command& command) {
+    switch (command.type) {
+        case Command::Type::Play:
+            mixer_.play(command.voice, std::move(command.sample), command.params, command.source);
+            break;
+        case Command::Type::PlayStream:
+            mixer_.play(command.voice, std::move(command.stream), command.params, command.source);
+            break;
+        case Command::Type::Stop:
+            mixer_.stop(command.voice);
+            break;
+        case Command::Type::StopSource:
+            mixer_.stop(command.source);
+            break;
+        case Command::Type::StopAll:
+            mixer_.stopAll();
+            break;
+        case Command::Type::SetGain:
+            mixer_.setGain(command.voice, command.value);
+            break;
+        case Command::Type::SetPan:
+            mixer_.setPan(command.voice, command.pan);
+            break;
+        case Command::Type::SetGainAndPan:
+            mixer_.setGain(command.voice, command.value);
+            mixer_.setPan(command.voice, command.pan);
+            break;
+        case Command::Type::SetPitch:
+            mixer_.setPitch(command.voice, command.value);
+            break;
+        case Command::Type::SetMaxVoices:
+            mixer_.setMaxVoices(command.count);
+            break;
+    }
+}
+
+void Audio::decoderLoop() {
+    std::vector<std::shared_ptr<StreamingSound>> active;
+    std::unique_lock<std::mutex> lock(streamsMutex_);
+    while (!stopDecoder_) {
+        // A stream only referenced here was stopped or has been played to the end
+        std::erase_if(streams_, [](const auto& stream) { return stream.use_count() == 1; });
+        active = streams_;
+        lock.unlock();
+
+        bool produced = false;
+        for (const auto& stream : active) {
+            produced |= stream->decode();
+        }
+        active.clear();
+
+        lock.lock();
+        if (!produced) {
+            streamsChanged_.wait_for(lock, std::chrono::milliseconds(10));
         }
     }
 }
 
-}  // namespace ast
\ No newline at end of file
+}  // namespace ast
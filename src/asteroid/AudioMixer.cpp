@@ -0,0 +1,336 @@
+#include "asteroid/AudioMixer.hpp"
+
+#include <algorithm>
+
+#include "asteroid/StreamingSound.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AST_MIXER_SSE
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define AST_MIXER_NEON
+#endif
+
+namespace ast {
+
+namespace {
+
+// Gains applied to even and odd samples, which are the left and right channels of stereo
+struct ChannelGains {
+    float even;
+    float odd;
+};
+
+// dst[i] += src[i] * gain
+void mixAdd(float* dst, const float* src, std::size_t count, ChannelGains gains) {
+    std::size_t i = 0;
+#if defined(AST_MIXER_SSE)
+    const __m128 g = _mm_setr_ps(gains.even, gains.odd, gains.even, gains.odd);
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g));
+        __m128 b =
+            _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(_mm_loadu_ps(src + i + 4), g));
+        _mm_storeu_ps(dst + i, a);
+        _mm_storeu_ps(dst + i + 4, b);
+    }
+#elif defined(AST_MIXER_NEON)
+    const float lanes[4] = {gains.even, gains.odd, gains.even, gains.odd};
+    const float32x4_t g = vld1q_f32(lanes);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] += src[i] * (i % 2 == 0 ? gains.even : gains.odd);
+    }
+}
+
+constexpr float INT16_SCALE = 1.0f / 32768.0f;
+
+// dst[i] += src[i] / 32768 * gain
+void mixAdd(float* dst, const std::int16_t* src, std::size_t count, ChannelGains gains) {
+    gains.even *= INT16_SCALE;
+    gains.odd *= INT16_SCALE;
+    std::size_t i = 0;
+#if defined(AST_MIXER_SSE)
+    const __m128 g = _mm_setr_ps(gains.even, gains.odd, gains.even, gains.odd);
+    for (; i + 8 <= count; i += 8) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // Sign-extend to 32 bits by placing each value in the upper half and shifting back
+        __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+        __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(lo, g)));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(hi, g)));
+    }
+#elif defined(AST_MIXER_NEON)
+    const float lanes[4] = {gains.even, gains.odd, gains.even, gains.odd};
+    const float32x4_t g = vld1q_f32(lanes);
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t s = vld1q_s16(src + i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), lo, g));
+        vst1q_f32(dst + i + 4, vmlaq_f32(vld1q_f32(dst + i + 4), hi, g));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] += src[i] * (i % 2 == 0 ? gains.even : gains.odd);
+    }
+}
+
+float toFloat(float value) { return value; }
+float toFloat(std::int16_t value) { return value * INT16_SCALE; }
+
+// Pan attenuates the opposite channel of stereo output and is ignored otherwise
+ChannelGains makeChannelGains(float gain, float pan, int channels) {
+    if (channels != 2) {
+        return {gain, gain};
+    }
+    return {gain * std::min(1.0f, 1.0f - pan), gain * std::min(1.0f, 1.0f + pan)};
+}
+
+}  // namespace
+
+AudioMixer::AudioMixer(int channels, std::size_t maxVoices)
+    : voices_(MAX_VOICES),
+      streamBuffer_(MIX_FRAMES * channels),
+      channels_(channels),
+      maxVoices_(std::min(maxVoices, MAX_VOICES)) {
+    endedVoices_.reserve(MAX_VOICES);
+}
+
+bool AudioMixer::play(VoiceId id, std::shared_ptr<const AudioSample> sample,
+                      const VoiceParams& params, const void* source) {
+    if (!sample || sample->channels != channels_ || sample->frameCount == 0) {
+        endedVoices_.push_back(id);
+        return false;
+    }
+    Voice* voice = allocate(params.priority, id, params, source ? source : sample.get());
+    if (!voice) {
+        return false;
+    }
+    voice->sample = std::move(sample);
+    return true;
+}
+
+bool AudioMixer::play(VoiceId id, std::shared_ptr<StreamingSound> stream,
+                      const VoiceParams& params, const void* source) {
+    if (!stream) {
+        endedVoices_.push_back(id);
+        return false;
+    }
+    Voice* voice = allocate(params.priority, id, params, source);
+    if (!voice) {
+        return false;
+    }
+    voice->stream = std::move(stream);
+    voice->pitch = 1.0f;
+    return true;
+}
+
+void AudioMixer::stop(VoiceId id) {
+    if (Voice* voice = find(id)) {
+        release(*voice);
+    }
+}
+
+void AudioMixer::stop(const void* source) {
+    for (Voice& voice : getSlots()) {
+        if (voice.id != NULL_VOICE_ID && voice.source == source) {
+            release(voice);
+        }
+    }
+}
+
+void AudioMixer::stopAll() {
+    for (Voice& voice : getSlots()) {
+        if (voice.id != NULL_VOICE_ID) {
+            release(voice);
+        }
+    }
+}
+
+void AudioMixer::setGain(VoiceId id, float gain) {
+    if (Voice* voice = find(id)) {
+        voice->gain = gain;
+    }
+}
+
+void AudioMixer::setPan(VoiceId id, float pan) {
+    if (Voice* voice = find(id)) {
+        voice->pan = std::clamp(pan, -1.0f, 1.0f);
+    }
+}
+
+void AudioMixer::setPitch(VoiceId id, float pitch) {
+    if (Voice* voice = find(id)) {
+        voice->pitch = std::max(pitch, 0.0f);
+    }
+}
+
+bool AudioMixer::isPlaying(VoiceId id) const { return find(id) != nullptr; }
+
+bool AudioMixer::isPlaying(const void* source) const {
+    const auto slots = getSlots();
+    return std::any_of(slots.begin(), slots.end(), [source](const Voice& voice) {
+        return voice.id != NULL_VOICE_ID && voice.source == source;
+    });
+}
+
+void AudioMixer::mix(float* out, std::size_t frameCount) {
+    std::fill(out, out + frameCount * channels_, 0.0f);
+    if (activeCount_ == 0) {
+        return;
+    }
+    for (Voice& voice : getSlots()) {
+        if (voice.id == NULL_VOICE_ID) {
+            continue;
+        }
+        if (voice.stream) {
+            mixStream(voice, out, frameCount);
+        } else if (!voice.sample->data16.empty()) {
+            mixVoice(voice, voice.sample->data16.data(), out, frameCount);
+        } else {
+            mixVoice(voice, voice.sample->data.data(), out, frameCount);
+        }
+    }
+}
+
+void AudioMixer::setMaxVoices(std::size_t maxVoices) {
+    maxVoices = std::min(maxVoices, MAX_VOICES);
+    for (std::size_t i = maxVoices; i < maxVoices_; ++i) {
+        if (voices_[i].id != NULL_VOICE_ID) {
+            release(voices_[i]);
+        }
+    }
+    maxVoices_ = maxVoices;
+}
+
+AudioMixer::Stats AudioMixer::getStats() const {
+    return {activeCount_, maxVoices_, stolenVoices_, rejectedVoices_, streamUnderruns_};
+}
+
+AudioMixer::Voice* AudioMixer::find(VoiceId id) {
+    if (id == NULL_VOICE_ID) {
+        return nullptr;
+    }
+    const auto slots = getSlots();
+    auto it = std::find_if(slots.begin(), slots.end(),
+                           [id](const Voice& voice) { return voice.id == id; });
+    return it != slots.end() ? &*it : nullptr;
+}
+
+const AudioMixer::Voice* AudioMixer::find(VoiceId id) const {
+    return const_cast<AudioMixer*>(this)->find(id);
+}
+
+AudioMixer::Voice* AudioMixer::allocate(int priority, VoiceId id, const VoiceParams& params,
+                                        const void* source) {
+    Voice* slot = nullptr;
+    Voice* victim = nullptr;
+    for (Voice& voice : getSlots()) {
+        if (voice.id == NULL_VOICE_ID) {
+            slot = &voice;
+            break;
+        }
+        if (!victim || voice.priority < victim->priority ||
+            (voice.priority == victim->priority && voice.startOrder < victim->startOrder)) {
+            victim = &voice;
+        }
+    }
+    if (!slot) {
+        if (!victim || victim->priority > priority) {
+            ++rejectedVoices_;
+            endedVoices_.push_back(id);
+            return nullptr;
+        }
+        ++stolenVoices_;
+        release(*victim);
+        slot = victim;
+    }
+    slot->id = id;
+    slot->source = source;
+    slot->position = 0.0;
+    slot->gain = params.gain;
+    slot->pan = std::clamp(params.pan, -1.0f, 1.0f);
+    slot->pitch = std::max(params.pitch, 0.0f);
+    slot->priority = priority;
+    slot->loops = params.loops;
+    slot->startOrder = nextStartOrder_++;
+    ++activeCount_;
+    return slot;
+}
+
+void AudioMixer::release(Voice& voice) {
+    endedVoices_.push_back(voice.id);
+    voice.id = NULL_VOICE_ID;
+    voice.sample.reset();
+    voice.stream.reset();
+    voice.source = nullptr;
+    --activeCount_;
+}
+
+template <typename T>
+void AudioMixer::mixVoice(Voice& voice, const T* src, float* out, std::size_t frameCount) {
+    const AudioSample& sample = *voice.sample;
+    const auto sampleFrames = static_cast<double>(sample.frameCount);
+    const ChannelGains gains = makeChannelGains(voice.gain, voice.pan, channels_);
+    std::size_t written = 0;
+
+    while (written < frameCount) {
+        if (voice.pitch == 1.0f && voice.position == static_cast<std::size_t>(voice.position)) {
+            // Same rate as the output: mix whole runs of frames
+            auto start = static_cast<std::size_t>(voice.position);
+            std::size_t count = std::min(frameCount - written, sample.frameCount - start);
+            mixAdd(out + written * channels_, src + start * channels_, count * channels_, gains);
+            written += count;
+            voice.position += static_cast<double>(count);
+        } else {
+            // Resample with linear interpolation
+            for (; written < frameCount && voice.position < sampleFrames; ++written) {
+                auto index = static_cast<std::size_t>(voice.position);
+                auto next = std::min(index + 1, sample.frameCount - 1);
+                auto t = static_cast<float>(voice.position - static_cast<double>(index));
+                float* dst = out + written * channels_;
+                const T* a = src + index * channels_;
+                const T* b = src + next * channels_;
+                for (int c = 0; c < channels_; ++c) {
+                    float from = toFloat(a[c]);
+                    dst[c] += (from + (toFloat(b[c]) - from) * t) *
+                              (c % 2 == 0 ? gains.even : gains.odd);
+                }
+                voice.position += voice.pitch;
+            }
+        }
+
+        if (voice.position >= sampleFrames) {
+            if (voice.loops != 0 && --voice.loops == 0) {
+                release(voice);
+                return;
+            }
+            voice.position -= sampleFrames;
+        }
+    }
+}
+
+void AudioMixer::mixStream(Voice& voice, float* out, std::size_t frameCount) {
+    const ChannelGains gains = makeChannelGains(voice.gain, voice.pan, channels_);
+    // Read in chunks so the buffer never grows on the audio thread
+    for (std::size_t written = 0; written < frameCount;) {
+        std::size_t count = std::min(frameCount - written, MIX_FRAMES);
+        std::size_t frames = voice.stream->read(streamBuffer_.data(), count);
+        mixAdd(out + written * channels_, streamBuffer_.data(), frames * channels_, gains);
+        written += frames;
+        if (frames < count) {
+            if (voice.stream->isFinished()) {
+                release(voice);
+            } else {
+                ++streamUnderruns_;
+            }
+            return;
+        }
+    }
+}
+
+}  // namespace ast
@@ -2,63 +2,543 @@
 
 #include <SDL3_image/SDL_image.h>
 
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+#include "asteroid/AssetPack.hpp"
 
 namespace ast {
 
+namespace {
+
+// Textures are uploaded as 32-bit RGBA; good enough for budgeting
+constexpr std::size_t BYTES_PER_PIXEL = 4;
+
+std::size_t textureBytes(int width, int height) {
+    return static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * BYTES_PER_PIXEL;
+}
+
+}  // namespace
+
 Cache& Cache::getInstance() {
     static Cache cache;
     return cache;
 }
 
+Cache::~Cache() { stopWorkers(); }
+
 const Texture& Cache::getTexture(const std::string& fileName) {
-    return getInstance().getTextureImpl(fileName);
+    Cache& cache = getInstance();
+    return cache.getTextureImpl(cache.resolve(fileName));
+}
+
+const Texture& Cache::getTexture(TextureId id) { return getInstance().getTextureImpl(id); }
+
+TextureId Cache::getTextureId(std::string_view fileName) {
+    return getInstance().resolve(fileName);
+}
+
+TextureId Cache::findTextureId(std::uint64_t nameHash) {
+    Cache& cache = getInstance();
+    std::lock_guard<std::mutex> lock(cache.idsMutex_);
+    auto [first, last] = cache.ids_.equal_range(nameHash);
+    if (first == last) {
+        return NULL_TEXTURE_ID;
+    }
+    // Ids are assigned in order, so the smallest belongs to the first name resolved
+    return std::min_element(first, last, [](const auto& a, const auto& b) {
+               return a.second < b.second;
+           })->second;
+}
+
+TextureId Cache::loadTexture(std::string_view fileName) {
+    Cache& cache = getInstance();
+    TextureId id = cache.resolve(fileName);
+    cache.getTextureImpl(id);
+    return id;
 }
 
 Texture Cache::getDummyTexture(const ast::Color& color) {
     return getInstance().getDummyTextureImpl(color);
 }
 
+TextureHandle Cache::acquireTexture(TextureId id) {
+    Cache& cache = getInstance();
+    cache.getTextureImpl(id);
+    if (id >= cache.entries_.size() || !cache.entries_[id].texture.handle) {
+        return {};
+    }
+    return TextureHandle(id);
+}
+
+TextureHandle Cache::acquireTexture(const std::string& fileName) {
+    return acquireTexture(getInstance().resolve(fileName));
+}
+
+const Texture& Cache::requestTexture(const std::string& fileName, const Texture& placeholder) {
+    Cache& cache = getInstance();
+    return cache.requestTextureImpl(cache.resolve(fileName), placeholder);
+}
+
+const Texture& Cache::requestTexture(TextureId id, const Texture& placeholder) {
+    return getInstance().requestTextureImpl(id, placeholder);
+}
+
+void Cache::preload(const std::vector<std::string>& fileNames, PreloadCallback onComplete) {
+    getInstance().preloadImpl(fileNames, std::move(onComplete));
+}
+
+void Cache::update(double budgetSec) { getInstance().updateImpl(budgetSec); }
+
+std::size_t Cache::getPendingCount() { return getInstance().pending_.size(); }
+
+void Cache::setMemoryBudget(std::size_t bytes) { getInstance().memoryBudget_ = bytes; }
+
+Cache::Stats Cache::getStats() {
+    const Cache& cache = getInstance();
+    Stats stats;
+    stats.residentBytes = cache.residentBytes_;
+    stats.budgetBytes = cache.memoryBudget_;
+    for (std::size_t id = 0; id < cache.entries_.size(); ++id) {
+        stats.textureCount += cache.entries_[id].texture.handle != nullptr;
+    }
+    stats.atlasPageCount = static_cast<std::size_t>(
+        std::count_if(cache.pages_.begin(), cache.pages_.end(),
+                      [](const AtlasPage& page) { return page.handle != nullptr; }));
+    stats.dummyTextureCount = cache.dummyTextures_.size();
+    stats.hits = cache.hits_;
+    stats.misses = cache.misses_;
+    stats.evictions = cache.evictions_;
+    return stats;
+}
+
+void Cache::setAtlasOptions(const AtlasOptions& options) {
+    getInstance().atlasOptions_ = options;
+}
+
+bool Cache::saveAtlasLayout(const std::filesystem::path& path) {
+    Cache& cache = getInstance();
+    const AtlasOptions& options = cache.atlasOptions_;
+
+    nlohmann::json entries = nlohmann::json::object();
+    auto writeEntry = [&entries](const std::string& name, const AtlasPlacement& placement) {
+        entries[name] = {{"page", placement.page},
+                         {"x", placement.x},
+                         {"y", placement.y},
+                         {"w", placement.width},
+                         {"h", placement.height}};
+    };
+    for (const auto& [name, placement] : cache.atlasLayout_) {
+        writeEntry(name, placement);
+    }
+    for (std::size_t id = 0; id < cache.entries_.size(); ++id) {
+        const Entry& entry = cache.entries_[id];
+        if (entry.page == NO_PAGE) {
+            continue;
+        }
+        const Rect& source = entry.texture.source;
+        writeEntry(entry.fileName,
+                   {entry.page, static_cast<int>(source.x) - options.padding,
+                    static_cast<int>(source.y) - options.padding, static_cast<int>(source.w),
+                    static_cast<int>(source.h)});
+    }
+
+    nlohmann::json layout = {{"pageSize", options.pageSize},
+                             {"padding", options.padding},
+                             {"pages", cache.pages_.size()},
+                             {"entries", std::move(entries)}};
+    std::ofstream file(path);
+    if (!file) {
+        AST_ERROR("Cannot write atlas layout to {}", path.string());
+        return false;
+    }
+    file << layout.dump(1);
+    AST_INFO("Saved atlas layout with {} page(s) to {}", cache.pages_.size(), path.string());
+    return true;
+}
+
+bool Cache::loadAtlasLayout(const std::filesystem::path& path) {
+    Cache& cache = getInstance();
+    if (!cache.pages_.empty()) {
+        AST_WARN("Atlas pages already in use, ignoring layout {}", path.string());
+        return false;
+    }
+    std::ifstream file(path);
+    if (!file) {
+        AST_WARN("Atlas layout {} not found", path.string());
+        return false;
+    }
+    nlohmann::json layout = nlohmann::json::parse(file, nullptr, false);
+    if (layout.is_discarded() || !layout.contains("entries")) {
+        AST_ERROR("Invalid atlas layout {}", path.string());
+        return false;
+    }
+    if (layout.value("pageSize", 0) != cache.atlasOptions_.pageSize ||
+        layout.value("padding", -1) != cache.atlasOptions_.padding) {
+        AST_WARN("Atlas layout {} was built with different options, ignoring", path.string());
+        return false;
+    }
+
+    cache.atlasLayout_.clear();
+    for (const auto& [name, entry] : layout["entries"].items()) {
+        cache.atlasLayout_[name] = {entry.value("page", std::size_t{0}), entry.value("x", 0),
+                                    entry.value("y", 0), entry.value("w", 0), entry.value("h", 0)};
+    }
+    cache.layoutPageCount_ = layout.value("pages", std::size_t{0});
+    AST_INFO("Loaded atlas layout with {} entries from {}", cache.atlasLayout_.size(),
+             path.string());
+    return true;
+}
+
 void Cache::setAssetsDirectory(const std::filesystem::path& directory) {
     getInstance().assetsDirectory_ = directory;
 }
 
 void Cache::init(SDL_Renderer* renderer) {
+    Cache& cache = getInstance();
     clear();
-    getInstance().renderer_ = renderer;
-    MISSING_TEXTURE = getInstance().getDummyTextureImpl(ast::Color::MAGENTA);
+    // Dummy textures belong to the previous renderer
+    cache.destroyDummyTextures();
+    cache.renderer_ = renderer;
+    if (!renderer) {
+        // Headless: decoded images could never be uploaded
+        cache.stopWorkers();
+        return;
+    }
+    MISSING_TEXTURE = cache.getDummyTextureImpl(ast::Color::MAGENTA);
+    cache.startWorkers();
+}
+
+void Cache::shutdown() {
+    Cache& cache = getInstance();
+    cache.stopWorkers();
+    clear();
+    cache.destroyDummyTextures();
 }
 
 void Cache::clear() {
-    for (auto& pair : getInstance().textures_) {
-        if (pair.second.handle) {
-            SDL_DestroyTexture(pair.second.handle);
+    Cache& cache = getInstance();
+    // Ids stay assigned so that ids and handles held elsewhere remain valid
+    for (std::size_t id = 0; id < cache.entries_.size(); ++id) {
+        Entry& entry = cache.entries_[id];
+        cache.releaseTexture(entry);
+        entry.failed = false;
+    }
+    for (auto& page : cache.pages_) {
+        if (page.handle) {
+            SDL_DestroyTexture(page.handle);
+            cache.residentBytes_ -= textureBytes(page.packer.getWidth(), page.packer.getHeight());
         }
     }
-    getInstance().textures_.clear();
+    cache.pages_.clear();
+    // Slots on the pages just dropped are free again
+    std::erase_if(cache.atlasLayout_, [&cache](const auto& item) {
+        return item.second.page >= cache.layoutPageCount_;
+    });
+
+    // Cancel outstanding requests; results still in flight are dropped by generation
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex_);
+        ++cache.generation_;
+        cache.decodeQueue_.clear();
+        for (auto& result : cache.decoded_) {
+            SDL_DestroySurface(result.surface);
+        }
+        cache.decoded_.clear();
+    }
+    for (auto& result : cache.uploads_) {
+        SDL_DestroySurface(result.surface);
+    }
+    cache.uploads_.clear();
+    cache.pending_.clear();
+    cache.preloadGroups_.clear();
+    cache.completedPreloads_.clear();
 }
 
-const Texture& Cache::getTextureImpl(const std::string& fileName) {
+TextureId Cache::resolve(std::string_view fileName) {
+    const std::uint64_t hash = hashString(fileName);
+    std::lock_guard<std::mutex> lock(idsMutex_);
+    auto [first, last] = ids_.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        if (entries_[it->second].fileName == fileName) {
+            return it->second;
+        }
+    }
+    if (first != last) {
+        AST_WARN("Texture name hash collision between '{}' and '{}'",
+                 entries_[first->second].fileName, fileName);
+    }
+    TextureId id = entries_.append(Entry{.fileName = std::string(fileName)});
+    if (id == NULL_TEXTURE_ID) {
+        AST_ERROR("Too many texture names, cannot add '{}'", fileName);
+        return id;
+    }
+    ids_.emplace(hash, id);
+    return id;
+}
+
+TextureId Cache::EntryTable::append(Entry entry) {
+    const std::size_t id = size_.load(std::memory_order_relaxed);
+    if (id >= CHUNK_SIZE * MAX_CHUNKS) {
+        return NULL_TEXTURE_ID;
+    }
+    std::unique_ptr<Entry[]>& chunk = chunks_[id / CHUNK_SIZE];
+    if (!chunk) {
+        chunk = std::make_unique<Entry[]>(CHUNK_SIZE);
+    }
+    chunk[id % CHUNK_SIZE] = std::move(entry);
+    // Publishes the entry to threads that read the size first
+    size_.store(id + 1, std::memory_order_release);
+    return static_cast<TextureId>(id);
+}
+
+Cache::Entry* Cache::findResident(TextureId id) {
+    if (id >= entries_.size() || !entries_[id].texture.handle) {
+        return nullptr;
+    }
+    Entry& entry = entries_[id];
+    ++hits_;
+    entry.lastUsedFrame = frame_;
+    return &entry;
+}
+
+const Texture& Cache::getTextureImpl(TextureId id) {
     // Check if already loaded
-    auto it = textures_.find(fileName);
-    if (it != textures_.end()) {
-        return it->second;
+    if (Entry* entry = findResident(id)) {
+        return entry->texture;
     }
-    std::filesystem::path imagePath = assetsDirectory_ / fileName;
-    SDL_Texture* handle = IMG_LoadTexture(renderer_, imagePath.string().c_str());
-    if (!handle) {
+    if (id == NULL_TEXTURE_ID || id >= entries_.size() || entries_[id].failed) {
+        return MISSING_TEXTURE;
+    }
+    ++misses_;
+    std::filesystem::path imagePath = assetsDirectory_ / entries_[id].fileName;
+    SDL_Surface* surface = IMG_Load_IO(AssetPack::openIO(imagePath), true);
+    if (!surface) {
         SDL_ERROR();
+        entries_[id].failed = true;
         return MISSING_TEXTURE;
     }
-    Texture texture{.handle = handle};
-    SDL_GetTextureSize(handle, &texture.size.x, &texture.size.y);
-    return textures_[fileName] = texture;
+    const Texture& texture = addTexture(id, surface);
+    SDL_DestroySurface(surface);
+    return texture;
+}
+
+const Texture& Cache::addTexture(TextureId id, SDL_Surface* surface) {
+    Entry& entry = entries_[id];
+    Texture texture;
+    std::size_t bytes = 0;
+    std::size_t page = NO_PAGE;
+    if (atlasOptions_.enabled) {
+        if (auto packed = packTexture(entry.fileName, surface, page)) {
+            texture = *packed;
+            ++pages_[page].liveCount;
+        } else {
+            page = NO_PAGE;
+        }
+    }
+    if (!texture.handle) {
+        SDL_Texture* handle = SDL_CreateTextureFromSurface(renderer_, surface);
+        if (!handle) {
+            SDL_ERROR();
+            entry.failed = true;
+            return MISSING_TEXTURE;
+        }
+        Vector2 size{static_cast<float>(surface->w), static_cast<float>(surface->h)};
+        texture = Texture{.handle = handle, .size = size, .source = Rect{Vector2{}, size}};
+        bytes = textureBytes(surface->w, surface->h);
+        residentBytes_ += bytes;
+    }
+
+    entry.texture = texture;
+    entry.bytes = bytes;
+    entry.page = page;
+    entry.lastUsedFrame = frame_;
+    return entry.texture;
+}
+
+std::optional<Texture> Cache::packTexture(const std::string& fileName, SDL_Surface* surface,
+                                          std::size_t& pageIndex) {
+    const int padding = atlasOptions_.padding;
+    const int paddedWidth = surface->w + 2 * padding;
+    const int paddedHeight = surface->h + 2 * padding;
+    if (surface->w > atlasOptions_.maxImageSize || surface->h > atlasOptions_.maxImageSize ||
+        paddedWidth > atlasOptions_.pageSize || paddedHeight > atlasOptions_.pageSize) {
+        return std::nullopt;
+    }
+
+    AtlasPacker::Placement placement;
+    auto layoutIt = atlasLayout_.find(fileName);
+    if (layoutIt != atlasLayout_.end() && layoutIt->second.width == surface->w &&
+        layoutIt->second.height == surface->h) {
+        pageIndex = layoutIt->second.page;
+        placement = {layoutIt->second.x, layoutIt->second.y};
+    } else {
+        // First fit over the pages that are not reserved by a loaded layout
+        pageIndex = layoutPageCount_;
+        for (;; ++pageIndex) {
+            if (pageIndex >= pages_.size()) {
+                pages_.resize(pageIndex + 1, AtlasPage{
+                    .packer = AtlasPacker(atlasOptions_.pageSize, atlasOptions_.pageSize)});
+            }
+            if (auto packed = pages_[pageIndex].packer.pack(paddedWidth, paddedHeight)) {
+                placement = *packed;
+                break;
+            }
+        }
+    }
+
+    SDL_Texture* page = getAtlasPage(pageIndex);
+    if (!page) {
+        return std::nullopt;
+    }
+    // Blit onto a zeroed surface so the padding is transparent whatever the page holds
+    SDL_Surface* padded = SDL_CreateSurface(paddedWidth, paddedHeight, SDL_PIXELFORMAT_RGBA32);
+    if (!padded) {
+        SDL_ERROR();
+        return std::nullopt;
+    }
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    SDL_Rect imageRect{padding, padding, surface->w, surface->h};
+    SDL_BlitSurface(surface, nullptr, padded, &imageRect);
+    SDL_Rect pageRect{placement.x, placement.y, paddedWidth, paddedHeight};
+    bool uploaded = SDL_UpdateTexture(page, &pageRect, padded->pixels, padded->pitch);
+    SDL_DestroySurface(padded);
+    if (!uploaded) {
+        SDL_ERROR();
+        return std::nullopt;
+    }
+
+    Vector2 size{static_cast<float>(surface->w), static_cast<float>(surface->h)};
+    return Texture{.handle = page,
+                   .size = size,
+                   .source = Rect{static_cast<float>(placement.x + padding),
+                                  static_cast<float>(placement.y + padding), size.x, size.y}};
+}
+
+SDL_Texture* Cache::getAtlasPage(std::size_t index) {
+    if (index >= pages_.size()) {
+        pages_.resize(index + 1, AtlasPage{
+            .packer = AtlasPacker(atlasOptions_.pageSize, atlasOptions_.pageSize)});
+    }
+    AtlasPage& page = pages_[index];
+    if (!page.handle) {
+        page.handle = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                        page.packer.getWidth(), page.packer.getHeight());
+        if (!page.handle) {
+            SDL_ERROR();
+            return nullptr;
+        }
+        SDL_SetTextureBlendMode(page.handle, SDL_BLENDMODE_BLEND);
+        residentBytes_ += textureBytes(page.packer.getWidth(), page.packer.getHeight());
+        AST_INFO("Created atlas page {} ({}x{})", index, page.packer.getWidth(),
+                 page.packer.getHeight());
+    }
+    return page.handle;
+}
+
+void Cache::releaseTexture(Entry& entry) {
+    if (!entry.texture.handle) {
+        return;
+    }
+    if (entry.page != NO_PAGE) {
+        // The packer keeps the slot reserved, so a reload goes back to the same place
+        const Rect& source = entry.texture.source;
+        atlasLayout_[entry.fileName] = {entry.page,
+                                        static_cast<int>(source.x) - atlasOptions_.padding,
+                                        static_cast<int>(source.y) - atlasOptions_.padding,
+                                        static_cast<int>(source.w), static_cast<int>(source.h)};
+        AtlasPage& page = pages_[entry.page];
+        if (--page.liveCount == 0) {
+            SDL_DestroyTexture(page.handle);
+            page.handle = nullptr;
+            residentBytes_ -= textureBytes(page.packer.getWidth(), page.packer.getHeight());
+        }
+    } else {
+        SDL_DestroyTexture(entry.texture.handle);
+        residentBytes_ -= entry.bytes;
+    }
+    entry.texture = Texture{};
+    entry.bytes = 0;
+    entry.page = NO_PAGE;
+}
+
+void Cache::evictToBudget() {
+    if (memoryBudget_ == 0 || residentBytes_ <= memoryBudget_) {
+        return;
+    }
+    // Textures used in this or the previous frame are likely on screen; evicting them
+    // would only cause them to be reloaded right away
+    auto isIdle = [this](const Entry& entry) {
+        return entry.refCount == 0 && entry.lastUsedFrame + 1 < frame_;
+    };
+
+    // Releasing a single packed image frees nothing while the rest of its page is resident,
+    // so pages are candidates as a whole, aged by their most recently used image
+    struct Candidate {
+        std::uint64_t lastUsedFrame = 0;
+        Entry* entry = nullptr;  // null for an atlas page
+        std::size_t page = NO_PAGE;
+    };
+    std::vector<Candidate> candidates;
+    std::vector<std::uint64_t> pageLastUsed(pages_.size(), 0);
+    std::vector<char> pageIdle(pages_.size(), 1);
+    for (std::size_t id = 0; id < entries_.size(); ++id) {
+        Entry& entry = entries_[id];
+        if (!entry.texture.handle) {
+            continue;
+        }
+        if (entry.page == NO_PAGE) {
+            if (isIdle(entry)) {
+                candidates.push_back({entry.lastUsedFrame, &entry});
+            }
+        } else {
+            pageIdle[entry.page] &= isIdle(entry);
+            pageLastUsed[entry.page] = std::max(pageLastUsed[entry.page], entry.lastUsedFrame);
+        }
+    }
+    for (std::size_t index = 0; index < pages_.size(); ++index) {
+        if (pages_[index].liveCount > 0 && pageIdle[index]) {
+            candidates.push_back({pageLastUsed[index], nullptr, index});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.lastUsedFrame < b.lastUsedFrame;
+    });
+
+    for (const Candidate& candidate : candidates) {
+        if (residentBytes_ <= memoryBudget_) {
+            break;
+        }
+        if (candidate.entry) {
+            AST_DEBUG("Evicting texture '{}'", candidate.entry->fileName);
+            releaseTexture(*candidate.entry);
+            ++evictions_;
+            continue;
+        }
+        AST_DEBUG("Evicting atlas page {}", candidate.page);
+        for (std::size_t id = 0; id < entries_.size(); ++id) {
+            Entry& entry = entries_[id];
+            if (entry.texture.handle && entry.page == candidate.page) {
+                releaseTexture(entry);
+                ++evictions_;
+            }
+        }
+    }
 }
 
 Texture Cache::getDummyTextureImpl(const ast::Color& color) {
+    auto key = static_cast<std::uint32_t>(color);
+    auto it = dummyTextures_.find(key);
+    if (it != dummyTextures_.end()) {
+        return it->second;
+    }
     Texture dummyTexture {
         .handle = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 1, 1),
-        .size = Vector2{1.0f, 1.0f}
+        .size = Vector2{1.0f, 1.0f},
+        .source = Rect{0.0f, 0.0f, 1.0f, 1.0f}
     };
     if (!dummyTexture.handle) {
         SDL_ERROR();
@@ -67,8 +547,231 @@ Texture Cache::getDummyTextureImpl(const ast::Color& color) {
         SDL_SetRenderDrawColor(renderer_, color.r, color.g, color.b, color.a);
         SDL_RenderClear(renderer_);
         SDL_SetRenderTarget(renderer_, nullptr);
+        dummyTextures_.emplace(key, dummyTexture);
+        residentBytes_ += textureBytes(1, 1);
     }
     return dummyTexture;
 }
 
-}  // namespace ast
\ No newline at end of file
+void Cache::destroyDummyTextures() {
+    for (auto& [color, texture] : dummyTextures_) {
+        SDL_DestroyTexture(texture.handle);
+        residentBytes_ -= textureBytes(1, 1);
+    }
+    dummyTextures_.clear();
+    MISSING_TEXTURE = Texture{};
+}
+
+const Texture& Cache::requestTextureImpl(TextureId id, const Texture& placeholder) {
+    if (Entry* entry = findResident(id)) {
+        return entry->texture;
+    }
+    if (id == NULL_TEXTURE_ID || id >= entries_.size() || entries_[id].failed) {
+        return placeholder;
+    }
+    if (workers_.empty()) {
+        // No workers to decode on, fall back to a blocking load
+        return getTextureImpl(id);
+    }
+    if (pending_.try_emplace(id).second) {
+        ++misses_;
+        enqueueDecode(id);
+    }
+    return placeholder;
+}
+
+void Cache::preloadImpl(const std::vector<std::string>& fileNames, PreloadCallback onComplete) {
+    std::size_t groupId = nextPreloadGroup_++;
+    PreloadGroup group{.onComplete = std::move(onComplete)};
+    for (const auto& fileName : fileNames) {
+        TextureId id = resolve(fileName);
+        if (findResident(id) || id == NULL_TEXTURE_ID || entries_[id].failed) {
+            continue;
+        }
+        if (workers_.empty()) {
+            getTextureImpl(id);
+            continue;
+        }
+        auto [it, inserted] = pending_.try_emplace(id);
+        if (inserted) {
+            ++misses_;
+            enqueueDecode(id);
+        }
+        if (std::find(it->second.begin(), it->second.end(), groupId) == it->second.end()) {
+            it->second.push_back(groupId);
+            ++group.remaining;
+        }
+    }
+    if (group.remaining > 0) {
+        preloadGroups_.emplace(groupId, std::move(group));
+    } else if (group.onComplete) {
+        // Everything is already resident, report completion on the next update
+        completedPreloads_.push_back(std::move(group.onComplete));
+    }
+}
+
+void Cache::updateImpl(double budgetSec) {
+    ++frame_;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& result : decoded_) {
+            if (result.generation == generation_) {
+                uploads_.push_back(std::move(result));
+            } else {
+                SDL_DestroySurface(result.surface);
+            }
+        }
+        decoded_.clear();
+    }
+
+    const Uint64 start = SDL_GetPerformanceCounter();
+    const Uint64 budget = static_cast<Uint64>(budgetSec * SDL_GetPerformanceFrequency());
+    while (!uploads_.empty()) {
+        DecodeResult result = std::move(uploads_.front());
+        uploads_.pop_front();
+        uploadDecoded(result);
+        finishRequest(result.id);
+        if (SDL_GetPerformanceCounter() - start >= budget) {
+            break;
+        }
+    }
+
+    evictToBudget();
+
+    // Callbacks may issue new preloads, so run them from a local list
+    std::vector<PreloadCallback> callbacks;
+    std::swap(callbacks, completedPreloads_);
+    for (auto& callback : callbacks) {
+        callback();
+    }
+}
+
+void Cache::enqueueDecode(TextureId id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        decodeQueue_.push_back({id, assetsDirectory_ / entries_[id].fileName});
+    }
+    workAvailable_.notify_one();
+}
+
+void Cache::uploadDecoded(DecodeResult& result) {
+    if (!result.surface) {
+        entries_[result.id].failed = true;
+        return;
+    }
+    // A blocking getTexture() may have loaded the image in the meantime
+    if (!entries_[result.id].texture.handle) {
+        addTexture(result.id, result.surface);
+    }
+    SDL_DestroySurface(result.surface);
+    result.surface = nullptr;
+}
+
+void Cache::finishRequest(TextureId id) {
+    auto it = pending_.find(id);
+    if (it == pending_.end()) {
+        return;
+    }
+    for (std::size_t groupId : it->second) {
+        auto groupIt = preloadGroups_.find(groupId);
+        if (groupIt != preloadGroups_.end() && --groupIt->second.remaining == 0) {
+            if (groupIt->second.onComplete) {
+                completedPreloads_.push_back(std::move(groupIt->second.onComplete));
+            }
+            preloadGroups_.erase(groupIt);
+        }
+    }
+    pending_.erase(it);
+}
+
+void Cache::startWorkers() {
+    if (!workers_.empty()) {
+        return;
+    }
+    unsigned count = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    AST_INFO("Starting {} texture decode worker(s)", count);
+    for (unsigned i = 0; i < count; ++i) {
+        workers_.emplace_back(&Cache::workerLoop, this);
+    }
+}
+
+void Cache::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = false;
+    decodeQueue_.clear();
+    for (auto& result : decoded_) {
+        SDL_DestroySurface(result.surface);
+    }
+    decoded_.clear();
+}
+
+void Cache::workerLoop() {
+    for (;;) {
+        DecodeRequest request;
+        unsigned generation = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [this] { return stopping_ || !decodeQueue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            request = std::move(decodeQueue_.front());
+            decodeQueue_.pop_front();
+            generation = generation_;
+        }
+
+        SDL_Surface* surface = IMG_Load_IO(AssetPack::openIO(request.path), true);
+        if (!surface) {
+            SDL_ERROR();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        decoded_.push_back({request.id, surface, generation});
+    }
+}
+
+TextureHandle::TextureHandle(TextureId id) : id_(id) {
+    if (id_ != NULL_TEXTURE_ID) {
+        ++Cache::getInstance().entries_[id_].refCount;
+    }
+}
+
+TextureHandle::TextureHandle(const TextureHandle& other) : TextureHandle(other.id_) {}
+
+TextureHandle::TextureHandle(TextureHandle&& other) noexcept : id_(other.id_) {
+    other.id_ = NULL_TEXTURE_ID;
+}
+
+TextureHandle& TextureHandle::operator=(TextureHandle other) noexcept {
+    std::swap(id_, other.id_);
+    return *this;
+}
+
+TextureHandle::~TextureHandle() {
+    if (id_ != NULL_TEXTURE_ID) {
+        Cache& cache = Cache::getInstance();
+        --cache.entries_[id_].refCount;
+        cache.entries_[id_].lastUsedFrame = cache.frame_;
+    }
+}
+
+const Texture& TextureHandle::get() const {
+    const Texture& texture = Cache::getInstance().entries_[id_].texture;
+    return texture.handle ? texture : Cache::MISSING_TEXTURE;
+}
+
+TextureHandle::operator bool() const {
+    return Cache::getInstance().entries_[id_].texture.handle != nullptr;
+}
+
+}  // namespace ast
@@ -0,0 +1,89 @@
+#include "asteroid/Camera.hpp"
+
+#include <bit>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define AST_CULL_SSE
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AST_CULL_NEON
+#endif
+
+namespace ast {
+
+static_assert(sizeof(Rect) == 4 * sizeof(float), "cullRects() loads a Rect as four floats");
+
+std::size_t cullRects(std::span<const Rect> bounds, const Rect& area,
+                      std::vector<std::uint32_t>& visible) {
+    const std::size_t before = visible.size();
+    const std::size_t count = bounds.size();
+    const float left = area.x;
+    const float top = area.y;
+    const float right = area.x + area.w;
+    const float bottom = area.y + area.h;
+    const float* data = reinterpret_cast<const float*>(bounds.data());
+    std::size_t i = 0;
+
+#if defined(AST_CULL_SSE)
+    const __m128 leftV = _mm_set1_ps(left);
+    const __m128 topV = _mm_set1_ps(top);
+    const __m128 rightV = _mm_set1_ps(right);
+    const __m128 bottomV = _mm_set1_ps(bottom);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(data + i * 4);
+        __m128 y = _mm_loadu_ps(data + i * 4 + 4);
+        __m128 w = _mm_loadu_ps(data + i * 4 + 8);
+        __m128 h = _mm_loadu_ps(data + i * 4 + 12);
+        // Rows of x, y, w, h to columns of four rects each
+        _MM_TRANSPOSE4_PS(x, y, w, h);
+        const __m128 overlapX =
+            _mm_and_ps(_mm_cmplt_ps(x, rightV), _mm_cmpgt_ps(_mm_add_ps(x, w), leftV));
+        const __m128 overlapY =
+            _mm_and_ps(_mm_cmplt_ps(y, bottomV), _mm_cmpgt_ps(_mm_add_ps(y, h), topV));
+        int mask = _mm_movemask_ps(_mm_and_ps(overlapX, overlapY));
+        while (mask) {
+            const int lane = std::countr_zero(static_cast<unsigned>(mask));
+            visible.push_back(static_cast<std::uint32_t>(i + lane));
+            mask &= mask - 1;
+        }
+    }
+#elif defined(AST_CULL_NEON)
+    const float32x4_t leftV = vdupq_n_f32(left);
+    const float32x4_t topV = vdupq_n_f32(top);
+    const float32x4_t rightV = vdupq_n_f32(right);
+    const float32x4_t bottomV = vdupq_n_f32(bottom);
+    for (; i + 4 <= count; i += 4) {
+        // Deinterleaves four rects into x, y, w and h
+        const float32x4x4_t rects = vld4q_f32(data + i * 4);
+        const float32x4_t x = rects.val[0];
+        const float32x4_t y = rects.val[1];
+        const uint32x4_t overlapX = vandq_u32(
+            vcltq_f32(x, rightV), vcgtq_f32(vaddq_f32(x, rects.val[2]), leftV));
+        const uint32x4_t overlapY = vandq_u32(
+            vcltq_f32(y, bottomV), vcgtq_f32(vaddq_f32(y, rects.val[3]), topV));
+        const uint32x4_t overlap = vandq_u32(overlapX, overlapY);
+        if (vmaxvq_u32(overlap) == 0) {
+            continue;
+        }
+        std::uint32_t lanes[4];
+        vst1q_u32(lanes, overlap);
+        for (std::uint32_t lane = 0; lane < 4; ++lane) {
+            if (lanes[lane]) {
+                visible.push_back(static_cast<std::uint32_t>(i + lane));
+            }
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const Rect& rect = bounds[i];
+        if (rect.x < right && rect.x + rect.w > left && rect.y < bottom &&
+            rect.y + rect.h > top) {
+            visible.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    return visible.size() - before;
+}
+
+}  // namespace ast
@@ -2,17 +2,22 @@
 
 #include <SDL3_ttf/SDL_ttf.h>
 
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
 
+#include "asteroid/AssetPack.hpp"
 #include "asteroid/Audio.hpp"
 #include "asteroid/Cache.hpp"
 #include "asteroid/Input.hpp"
 #include "asteroid/Event.hpp"
 #include "asteroid/EventBus.hpp"
+#include "asteroid/Profiler.hpp"
 
 namespace ast {
 
-Engine::Engine(const std::string& title, int width, int height, const std::filesystem::path& assetsDir)
+Engine::Engine(const std::string& title, int width, int height,
+               const std::filesystem::path& assetsDir, Mode mode)
     : window_(nullptr),
       renderer_(nullptr),
       width_(width),
@@ -20,12 +25,14 @@ Engine::Engine(const std::string& title, int width, int height, const std::files
       title_(title),
       running_(false),
       assetsDirectory_(assetsDir),
-      timer_(60) {
+      timer_(60),
+      mode_(mode) {
     spdlog::set_pattern("%^[%L][%T] %s:%#: %v%$");
     spdlog::set_level(spdlog::level::trace);
     AST_INFO("Initializing SDL...");
 
-    if (!SDL_Init(SDL_INIT_VIDEO)) {
+    // Without a window only the event queue is needed, which works without a display
+    if (!SDL_Init(mode_ == Mode::Windowed ? SDL_INIT_VIDEO : SDL_INIT_EVENTS)) {
         SDL_ERROR();
         return;
     }
@@ -37,32 +44,52 @@ Engine::Engine(const std::string& title, int width, int height, const std::files
         return;
     }
 
-    AST_INFO("Creating window...");
-    window_ = SDL_CreateWindow(title_.c_str(), width_, height_, SDL_WINDOW_RESIZABLE);
-    if (!window_) {
-        SDL_ERROR();
-        SDL_Quit();
-        return;
-    }
+    if (mode_ == Mode::Windowed) {
+        AST_INFO("Creating window...");
+        window_ = SDL_CreateWindow(title_.c_str(), width_, height_, SDL_WINDOW_RESIZABLE);
+        if (!window_) {
+            SDL_ERROR();
+            SDL_Quit();
+            return;
+        }
 
-    AST_INFO("Creating renderer...");
-    renderer_ = SDL_CreateRenderer(window_, nullptr);
-    if (!renderer_) {
-        SDL_ERROR();
-        SDL_DestroyWindow(window_);
-        SDL_Quit();
-        return;
+        AST_INFO("Creating renderer...");
+        renderer_ = SDL_CreateRenderer(window_, nullptr);
+        if (!renderer_) {
+            SDL_ERROR();
+            SDL_DestroyWindow(window_);
+            SDL_Quit();
+            return;
+        }
+    } else if (mode_ == Mode::HeadlessSoftware) {
+        AST_INFO("Creating software renderer...");
+        surface_ = SDL_CreateSurface(width_, height_, SDL_PIXELFORMAT_RGBA32);
+        renderer_ = surface_ ? SDL_CreateSoftwareRenderer(surface_) : nullptr;
+        if (!renderer_) {
+            SDL_ERROR();
+            SDL_DestroySurface(surface_);
+            surface_ = nullptr;
+            SDL_Quit();
+            return;
+        }
+    }
+    if (renderer_) {
+        spriteBatch_.setRenderer(renderer_);
+        // SDL_SetDefaultTextureScaleMode(renderer, SDL_SCALEMODE_PIXELART);
+        SDL_SetRenderLogicalPresentation(renderer_, width_, height_,
+                                         SDL_LOGICAL_PRESENTATION_LETTERBOX);
     }
-    // SDL_SetDefaultTextureScaleMode(renderer, SDL_SCALEMODE_PIXELART);
-    SDL_SetRenderLogicalPresentation(renderer_, width_, height_,
-                                     SDL_LOGICAL_PRESENTATION_LETTERBOX);
 
     AST_INFO("Assets Directory: {}", assetsDirectory_.string());
     // Initialize texture cache
     ast::Cache::init(renderer_);
     ast::Cache::setAssetsDirectory(assetsDirectory_ / "images");
 
-    Audio::getInstance().init();
+    if (mode_ == Mode::Windowed) {
+        Audio::getInstance().init();
+    } else {
+        Audio::getInstance().initOffline();
+    }
     Audio::getInstance().setAssetsDirectory(assetsDirectory_ / "sounds");
 
     running_ = true;
@@ -70,7 +97,7 @@ Engine::Engine(const std::string& title, int width, int height, const std::files
 }
 
 Engine::~Engine() {
-    Cache::clear();
+    Cache::shutdown();
 
     TTF_Quit();
 
@@ -82,7 +109,12 @@ Engine::~Engine() {
         SDL_DestroyWindow(window_);
         window_ = nullptr;
     }
+    if (surface_) {
+        SDL_DestroySurface(surface_);
+        surface_ = nullptr;
+    }
     Audio::getInstance().shutdown();
+    AssetPack::closeAll();
     SDL_Quit();
 }
 
@@ -91,14 +123,150 @@ Engine::~Engine() {
 // }
 
 void Engine::run() {
+    timer_.reset();
+    accumulator_ = 0.0;
+    startLoop();
     while (running_) {
+        AST_PROFILE_ZONE("Frame");
+        timer_.startFrame();
+        // Clamp so that a long stall costs at most maxUpdateSteps_ steps
+        accumulator_ += std::min(timer_.getFrameTime(), fixedTimestep_ * maxUpdateSteps_);
+        int steps = std::min(static_cast<int>(accumulator_ / fixedTimestep_), maxUpdateSteps_);
+        accumulator_ -= steps * fixedTimestep_;
+        alpha_ = static_cast<float>(accumulator_ / fixedTimestep_);
+        runFrame(steps);
+        {
+            AST_PROFILE_ZONE("Timer::endFrame");
+            timer_.endFrame();
+        }
+    }
+    stopLoop();
+}
+
+int Engine::runFrames(int frameCount) {
+    startLoop();
+    alpha_ = 0.0f;
+    int frames = 0;
+    for (; frames < frameCount && running_; ++frames) {
+        AST_PROFILE_ZONE("Frame");
         timer_.startFrame();
-        clear(Color::WHITE);
+        runFrame(1);
+    }
+    stopLoop();
+    return frames;
+}
+
+void Engine::startLoop() {
+    Profiler::setThreadName("Main");
+    loopPipelined_ = pipelined_;
+    if (loopPipelined_) {
+        stopSimulation_ = false;
+        simulationThread_ = std::thread(&Engine::simulationLoop, this);
+    }
+}
+
+void Engine::stopLoop() {
+    if (loopPipelined_) {
+        {
+            std::lock_guard<std::mutex> lock(simulationMutex_);
+            stopSimulation_ = true;
+        }
+        simulationChanged_.notify_one();
+        simulationThread_.join();
+        loopPipelined_ = false;
+    }
+}
+
+void Engine::runFrame(int steps) {
+    if (sceneChanged_) {
+        // The simulation thread is idle between frames
+        scene_ = std::move(nextScene_);
+        sceneChanged_ = false;
+    }
+    {
+        AST_PROFILE_ZONE("handleEvents");
         handleEvents();
-        update(timer_.getDeltaTime());
-        present();
-        Audio::getInstance().update();
-        timer_.endFrame();
+    }
+    {
+        AST_PROFILE_ZONE("Cache::update");
+        Cache::update();
+    }
+
+    if (loopPipelined_) {
+        // Simulate the next frame while this one is drawn from the previous snapshot
+        {
+            std::lock_guard<std::mutex> lock(simulationMutex_);
+            pendingSteps_ = steps;
+            pendingAlpha_ = alpha_;
+            simulating_ = true;
+        }
+        simulationChanged_.notify_one();
+    } else {
+        simulate(steps, alpha_, snapshots_[frontSnapshot_]);
+    }
+
+    if (renderer_) {
+        {
+            AST_PROFILE_ZONE("render");
+            clear(Color::WHITE);
+            render(getRenderSnapshot().alpha);
+        }
+        {
+            AST_PROFILE_ZONE("present");
+            present();
+        }
+    } else {
+        renderQueue_.clear();
+    }
+    if (loopPipelined_) {
+        AST_PROFILE_ZONE("waitForSimulation");
+        std::unique_lock<std::mutex> lock(simulationMutex_);
+        simulationChanged_.wait(lock, [this] { return !simulating_; });
+        frontSnapshot_ = 1 - frontSnapshot_;
+    }
+    {
+        AST_PROFILE_ZONE("Audio::update");
+        Audio& audio = Audio::getInstance();
+        if (audio.isOffline()) {
+            // Advance the voices by the simulated time so that sounds end deterministically
+            audioFrames_ += steps * fixedTimestep_ * audio.getSampleRate();
+            auto frames = static_cast<std::size_t>(audioFrames_);
+            audioFrames_ -= static_cast<double>(frames);
+            audioBuffer_.resize(frames * audio.getChannels());
+            audio.render(audioBuffer_.data(), frames);
+        }
+        audio.update();
+    }
+}
+
+void Engine::simulate(int steps, float alpha, RenderSnapshot& snapshot) {
+    for (int i = 0; i < steps; ++i) {
+        AST_PROFILE_ZONE("update");
+        update(static_cast<float>(fixedTimestep_));
+        ++step_;
+    }
+    AST_PROFILE_ZONE("extract");
+    snapshot.clear();
+    extract(snapshot);
+    snapshot.step = step_;
+    snapshot.alpha = alpha;
+}
+
+void Engine::simulationLoop() {
+    Profiler::setThreadName("Simulation");
+    std::unique_lock<std::mutex> lock(simulationMutex_);
+    while (true) {
+        simulationChanged_.wait(lock, [this] { return simulating_ || stopSimulation_; });
+        if (stopSimulation_) {
+            break;
+        }
+        const int steps = pendingSteps_;
+        const float alpha = pendingAlpha_;
+        lock.unlock();
+        simulate(steps, alpha, snapshots_[1 - frontSnapshot_]);
+        lock.lock();
+        simulating_ = false;
+        simulationChanged_.notify_one();
     }
 }
 
@@ -119,11 +287,128 @@ void Engine::handleEvents() {
                 height_ = event.window.data2;
                 EventBus::publish(events::WindowResizeEvent{width_, height_});
                 break;
+            case SDL_EVENT_RENDER_TARGETS_RESET:
+            case SDL_EVENT_RENDER_DEVICE_RESET:
+                EventBus::publish(events::RenderTargetsResetEvent{});
+                break;
         }
     }
 }
 
-void Engine::update(float dt) {}
+void Engine::update(float dt) {
+    if (scene_) {
+        scene_->update(dt);
+    }
+}
+
+void Engine::extract(RenderSnapshot& snapshot) {
+    if (scene_) {
+        scene_->extract(snapshot);
+    }
+}
+
+void Engine::render(float alpha) {
+    drawSnapshot(getRenderSnapshot(), alpha);
+    if (scene_) {
+        scene_->render();
+    }
+    renderQueue_.execute(spriteBatch_);
+}
+
+void Engine::setScene(std::unique_ptr<Scene> scene) {
+    nextScene_ = std::move(scene);
+    sceneChanged_ = true;
+}
+
+void Engine::drawSnapshot(const RenderSnapshot& snapshot, float alpha) {
+    auto interpolate = [alpha](const SpriteDraw& sprite) {
+        return Rect{sprite.previous.x + (sprite.current.x - sprite.previous.x) * alpha,
+                    sprite.previous.y + (sprite.current.y - sprite.previous.y) * alpha,
+                    sprite.previous.w + (sprite.current.w - sprite.previous.w) * alpha,
+                    sprite.previous.h + (sprite.current.h - sprite.previous.h) * alpha};
+    };
+
+    // Reject the sprites outside the view before they reach the batch
+    spriteBounds_.clear();
+    for (const SpriteDraw& sprite : snapshot.sprites) {
+        Rect bounds = interpolate(sprite);
+        if (sprite.rotation != 0.0f) {
+            // The circle around the sprite contains it at any angle
+            const float radius = std::sqrt(bounds.w * bounds.w + bounds.h * bounds.h) * 0.5f;
+            bounds = Rect{bounds.x + bounds.w * 0.5f - radius, bounds.y + bounds.h * 0.5f - radius,
+                          radius * 2.0f, radius * 2.0f};
+        }
+        spriteBounds_.push_back(bounds);
+    }
+    Rect view;
+    if (snapshot.camera) {
+        view = snapshot.camera->getVisibleArea();
+    } else {
+        int width = 0;
+        int height = 0;
+        if (!SDL_GetRenderLogicalPresentation(renderer_, &width, &height, nullptr) ||
+            width == 0) {
+            // Without a logical presentation, render coordinates are output pixels
+            SDL_GetCurrentRenderOutputSize(renderer_, &width, &height);
+        }
+        view = Rect{0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)};
+    }
+    visibleSprites_.clear();
+    cullStats_.tested = spriteBounds_.size();
+    cullStats_.visible = cullRects(spriteBounds_, view, visibleSprites_);
+
+    for (std::uint32_t index : visibleSprites_) {
+        const SpriteDraw& sprite = snapshot.sprites[index];
+        const Texture& texture = Cache::getTexture(sprite.texture);
+        if (!texture.handle) {
+            continue;
+        }
+        Rect destination = interpolate(sprite);
+        if (snapshot.camera) {
+            destination = snapshot.camera->worldToScreen(destination);
+        }
+        spriteBatch_.draw(texture, destination, sprite.rotation, sprite.color, sprite.layer);
+    }
+    if (snapshot.camera) {
+        // Keep sprites straddling the viewport's edges inside it
+        const Rect& viewport = snapshot.camera->viewport;
+        const SDL_Rect clip{static_cast<int>(viewport.x), static_cast<int>(viewport.y),
+                            static_cast<int>(viewport.w), static_cast<int>(viewport.h)};
+        SDL_SetRenderClipRect(renderer_, &clip);
+        spriteBatch_.flush();
+        SDL_SetRenderClipRect(renderer_, nullptr);
+    } else {
+        spriteBatch_.flush();
+    }
+}
+
+void Engine::setFixedTimestep(double seconds) {
+    if (seconds <= 0.0) {
+        AST_WARN("Invalid fixed timestep {}, keeping {}", seconds, fixedTimestep_);
+        return;
+    }
+    fixedTimestep_ = seconds;
+}
+
+void Engine::setPacing(Timer::Pacing pacing) {
+    const bool vsync = pacing == Timer::Pacing::VSync;
+    // Headless engines have no display to sync to
+    const bool applied =
+        renderer_ && window_ &&
+        SDL_SetRenderVSync(renderer_, vsync ? 1 : SDL_RENDERER_VSYNC_DISABLED);
+    if (vsync && !applied) {
+        AST_WARN("VSync unavailable, pacing frames by sleeping instead");
+        pacing = Timer::Pacing::Sleep;
+    }
+    timer_.setPacing(pacing);
+}
+
+void Engine::setWorkerCount(std::size_t workerCount) {
+    jobs_.reset();
+    jobs_ = std::make_unique<JobSystem>(workerCount);
+}
+
+void Engine::setMaxUpdateSteps(int steps) { maxUpdateSteps_ = std::max(steps, 1); }
 
 void Engine::quit() { running_ = false; }
 
@@ -0,0 +1,202 @@
+#include "asteroid/Font.hpp"
+
+#include <SDL3_ttf/SDL_ttf.h>
+
+#include "asteroid/AssetPack.hpp"
+#include "asteroid/SpriteBatch.hpp"
+
+namespace ast {
+
+namespace {
+
+// Transparent border around each glyph to avoid bleeding when filtering
+constexpr int GLYPH_PADDING = 1;
+
+}  // namespace
+
+Font::Font(SDL_Renderer* renderer, const std::filesystem::path& file, float pointSize,
+           int pageSize)
+    : renderer_(renderer), pageSize_(pageSize) {
+    font_ = TTF_OpenFontIO(AssetPack::openIO(file), true, pointSize);
+    if (!font_) {
+        SDL_ERROR();
+        return;
+    }
+    lineHeight_ = static_cast<float>(TTF_GetFontLineSkip(font_));
+}
+
+Font::~Font() {
+    for (Page& page : pages_) {
+        SDL_DestroyTexture(page.handle);
+    }
+    if (font_) {
+        TTF_CloseFont(font_);
+    }
+}
+
+void Font::layout(std::string_view text, TextLayout& layout) {
+    layout.quads.clear();
+    layout.size = {};
+    if (!font_) {
+        return;
+    }
+    float penX = 0.0f;
+    float lineY = 0.0f;
+    std::uint32_t previous = 0;
+    const char* cursor = text.data();
+    std::size_t remaining = text.size();
+    while (remaining > 0) {
+        const std::uint32_t codepoint = SDL_StepUTF8(&cursor, &remaining);
+        if (codepoint == '\n') {
+            layout.size.x = std::max(layout.size.x, penX);
+            penX = 0.0f;
+            lineY += lineHeight_;
+            previous = 0;
+            continue;
+        }
+        if (previous != 0) {
+            penX += getKerning(previous, codepoint);
+        }
+        const Glyph& glyph = getGlyph(codepoint);
+        if (glyph.page) {
+            layout.quads.push_back({glyph.page, glyph.source,
+                                    Rect{penX + glyph.offsetX, lineY, glyph.source.w,
+                                         glyph.source.h}});
+        }
+        penX += glyph.advance;
+        previous = codepoint;
+    }
+    layout.size.x = std::max(layout.size.x, penX);
+    layout.size.y = lineY + lineHeight_;
+}
+
+const Font::TextLayout& Font::getLayout(std::string_view text) {
+    if (auto it = layouts_.find(text); it != layouts_.end()) {
+        return it->second;
+    }
+    if (layouts_.size() >= MAX_CACHED_LAYOUTS) {
+        AST_DEBUG("Font layout cache full, clearing {} layouts", layouts_.size());
+        layouts_.clear();
+    }
+    TextLayout& cached = layouts_.try_emplace(std::string(text)).first->second;
+    layout(text, cached);
+    return cached;
+}
+
+Vector2 Font::measure(std::string_view text) {
+    layout(text, scratch_);
+    return scratch_.size;
+}
+
+void Font::draw(SpriteBatch& batch, std::string_view text, Vector2 position, Color color,
+                int layer) {
+    layout(text, scratch_);
+    draw(batch, scratch_, position, color, layer);
+}
+
+void Font::draw(SpriteBatch& batch, const TextLayout& layout, Vector2 position, Color color,
+                int layer) const {
+    for (const GlyphQuad& quad : layout.quads) {
+        batch.draw(quad.page, quad.source,
+                   Rect{position.x + quad.destination.x, position.y + quad.destination.y,
+                        quad.destination.w, quad.destination.h},
+                   0.0f, color, layer);
+    }
+}
+
+const Font::Glyph& Font::getGlyph(std::uint32_t codepoint) {
+    auto [it, inserted] = glyphs_.try_emplace(codepoint);
+    Glyph& glyph = it->second;
+    if (!inserted) {
+        return glyph;
+    }
+    int minX = 0;
+    int maxX = 0;
+    int minY = 0;
+    int maxY = 0;
+    int advance = 0;
+    if (!TTF_GetGlyphMetrics(font_, codepoint, &minX, &maxX, &minY, &maxY, &advance)) {
+        SDL_ERROR();
+        return glyph;
+    }
+    glyph.advance = static_cast<float>(advance);
+    // Rendered glyphs start at the pen, or at the glyph's left edge when it overhangs
+    glyph.offsetX = static_cast<float>(std::min(minX, 0));
+    if (maxX > minX && !addToAtlas(codepoint, glyph)) {
+        glyph.page = nullptr;
+    }
+    return glyph;
+}
+
+bool Font::addToAtlas(std::uint32_t codepoint, Glyph& glyph) {
+    SDL_Surface* surface = TTF_RenderGlyph_Blended(font_, codepoint, SDL_Color{255, 255, 255, 255});
+    if (!surface) {
+        SDL_ERROR();
+        return false;
+    }
+    const int paddedWidth = surface->w + 2 * GLYPH_PADDING;
+    const int paddedHeight = surface->h + 2 * GLYPH_PADDING;
+    if (paddedWidth > pageSize_ || paddedHeight > pageSize_) {
+        AST_WARN("Glyph U+{:04X} ({}x{}) does not fit on a {} pixel atlas page", codepoint,
+                 surface->w, surface->h, pageSize_);
+        SDL_DestroySurface(surface);
+        return false;
+    }
+
+    // Glyphs only ever go on the newest page; older pages are full enough
+    std::optional<AtlasPacker::Placement> placement;
+    if (!pages_.empty()) {
+        placement = pages_.back().packer.pack(paddedWidth, paddedHeight);
+    }
+    if (!placement) {
+        SDL_Texture* handle = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32,
+                                                SDL_TEXTUREACCESS_STATIC, pageSize_, pageSize_);
+        if (!handle) {
+            SDL_ERROR();
+            SDL_DestroySurface(surface);
+            return false;
+        }
+        SDL_SetTextureBlendMode(handle, SDL_BLENDMODE_BLEND);
+        pages_.push_back({handle, AtlasPacker(pageSize_, pageSize_)});
+        placement = pages_.back().packer.pack(paddedWidth, paddedHeight);
+    }
+
+    // Blit onto a zeroed surface so the padding is transparent whatever the page holds
+    SDL_Surface* padded = SDL_CreateSurface(paddedWidth, paddedHeight, SDL_PIXELFORMAT_RGBA32);
+    bool uploaded = false;
+    if (padded) {
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+        SDL_Rect glyphRect{GLYPH_PADDING, GLYPH_PADDING, surface->w, surface->h};
+        SDL_BlitSurface(surface, nullptr, padded, &glyphRect);
+        SDL_Rect pageRect{placement->x, placement->y, paddedWidth, paddedHeight};
+        uploaded =
+            SDL_UpdateTexture(pages_.back().handle, &pageRect, padded->pixels, padded->pitch);
+        SDL_DestroySurface(padded);
+    }
+    if (!uploaded) {
+        SDL_ERROR();
+        SDL_DestroySurface(surface);
+        return false;
+    }
+
+    glyph.page = pages_.back().handle;
+    glyph.source = Rect{static_cast<float>(placement->x + GLYPH_PADDING),
+                        static_cast<float>(placement->y + GLYPH_PADDING),
+                        static_cast<float>(surface->w), static_cast<float>(surface->h)};
+    SDL_DestroySurface(surface);
+    return true;
+}
+
+float Font::getKerning(std::uint32_t previous, std::uint32_t codepoint) {
+    const std::uint64_t pair = static_cast<std::uint64_t>(previous) << 32 | codepoint;
+    auto [it, inserted] = kerning_.try_emplace(pair, 0.0f);
+    if (inserted) {
+        int kerning = 0;
+        if (TTF_GetGlyphKerning(font_, previous, codepoint, &kerning)) {
+            it->second = static_cast<float>(kerning);
+        }
+    }
+    return it->second;
+}
+
+}  // namespace ast
@@ -0,0 +1,174 @@
+#include "asteroid/JobSystem.hpp"
+
+#include <algorithm>
+
+namespace ast {
+
+namespace {
+
+// The job system the calling thread works for, and the index of its queue
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local std::size_t currentQueue = 0;
+
+}  // namespace
+
+JobSystem::JobSystem(std::size_t workerCount) {
+    queues_.reserve(workerCount + 1);
+    for (std::size_t i = 0; i <= workerCount; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    workers_.reserve(workerCount);
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        workers_.emplace_back(&JobSystem::workerLoop, this, i + 1);
+    }
+    AST_DEBUG("Started job system with {} worker(s)", workerCount);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wakeCondition_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    // Jobs may have been queued after the workers stopped looking
+    while (tryRun()) {
+    }
+}
+
+std::size_t JobSystem::getDefaultWorkerCount() {
+    return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+}
+
+void JobSystem::submit(Job job, JobCounter* counter) {
+    if (counter) {
+        counter->pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    push({std::move(job), counter});
+}
+
+void JobSystem::submitAfter(JobCounter& dependency, Job job, JobCounter* counter) {
+    if (counter) {
+        counter->pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(dependency.mutex_);
+        if (dependency.pending_.load(std::memory_order_acquire) != 0) {
+            dependency.continuations_.push_back({std::move(job), counter});
+            return;
+        }
+    }
+    push({std::move(job), counter});
+}
+
+void JobSystem::parallelFor(std::size_t count, std::size_t batchSize,
+                            const std::function<void(std::size_t, std::size_t)>& func) {
+    batchSize = std::max<std::size_t>(batchSize, 1);
+    JobCounter counter;
+    for (std::size_t begin = 0; begin < count; begin += batchSize) {
+        std::size_t end = std::min(begin + batchSize, count);
+        submit([&func, begin, end] { func(begin, end); }, &counter);
+    }
+    wait(counter);
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+        if (!tryRun()) {
+            std::this_thread::yield();
+        }
+    }
+    // The thread that finished the last job may still hold the mutex
+    std::lock_guard<std::mutex> lock(counter.mutex_);
+}
+
+void JobSystem::push(Task task) {
+    Queue& queue = *queues_[currentSystem == this ? currentQueue : 0];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    queuedCount_.fetch_add(1, std::memory_order_release);
+    if (!workers_.empty()) {
+        // Pairs with the check in workerLoop so that the wake-up cannot be missed
+        { std::lock_guard<std::mutex> lock(sleepMutex_); }
+        wakeCondition_.notify_one();
+    }
+}
+
+bool JobSystem::tryRun() {
+    const std::size_t own = currentSystem == this ? currentQueue : 0;
+    Task task;
+    bool found = false;
+    {
+        Queue& queue = *queues_[own];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            // Workers take their newest job; the shared queue runs in submission order
+            if (own != 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            found = true;
+        }
+    }
+    for (std::size_t i = 1; !found && i < queues_.size(); ++i) {
+        Queue& victim = *queues_[(own + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = true;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+    queuedCount_.fetch_sub(1, std::memory_order_relaxed);
+    run(task);
+    return true;
+}
+
+void JobSystem::run(Task& task) {
+    task.job();
+    if (task.counter) {
+        finish(*task.counter);
+    }
+}
+
+void JobSystem::finish(JobCounter& counter) {
+    std::vector<JobCounter::Continuation> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter.mutex_);
+        if (counter.pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(counter.continuations_);
+        }
+    }
+    for (JobCounter::Continuation& continuation : ready) {
+        push({std::move(continuation.job), continuation.counter});
+    }
+}
+
+void JobSystem::workerLoop(std::size_t index) {
+    currentSystem = this;
+    currentQueue = index;
+    while (true) {
+        if (tryRun()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wakeCondition_.wait(lock, [this] {
+            return stopping_ || queuedCount_.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping_) {
+            break;
+        }
+    }
+}
+
+}  // namespace ast
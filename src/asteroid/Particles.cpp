@@ -0,0 +1,247 @@
+#include "asteroid/Particles.hpp"
+
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+#include "asteroid/Cache.hpp"
+#include "asteroid/Profiler.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define AST_PARTICLES_SSE
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AST_PARTICLES_NEON
+#endif
+
+namespace ast {
+
+namespace {
+
+constexpr std::size_t SIMD_WIDTH = 4;
+// Slots without a live particle never die, so update() needs no mask for them
+constexpr float NEVER = std::numeric_limits<float>::infinity();
+
+}  // namespace
+
+ParticlePool::ParticlePool(std::size_t capacity)
+    : capacity_(capacity),
+      x_((capacity + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH),
+      y_(x_.size()),
+      velocityX_(x_.size()),
+      velocityY_(x_.size()),
+      age_(x_.size()),
+      lifetime_(x_.size(), NEVER),
+      particleSize_(x_.size()),
+      startColor_(x_.size()),
+      endColor_(x_.size()) {}
+
+bool ParticlePool::spawn(const ParticleSpawn& spawn) {
+    if (size_ == capacity_) {
+        return false;
+    }
+    const std::size_t i = size_++;
+    x_[i] = spawn.position.x;
+    y_[i] = spawn.position.y;
+    velocityX_[i] = spawn.velocity.x;
+    velocityY_[i] = spawn.velocity.y;
+    age_[i] = 0.0f;
+    lifetime_[i] = spawn.lifetime;
+    particleSize_[i] = spawn.size;
+    startColor_[i] = spawn.startColor;
+    endColor_[i] = spawn.endColor;
+    return true;
+}
+
+std::size_t ParticlePool::update(float dt, Vector2 acceleration, float drag) {
+    const float damping = std::max(1.0f - drag * dt, 0.0f);
+    const float accelerationX = acceleration.x * dt;
+    const float accelerationY = acceleration.y * dt;
+    bool anyDead = false;
+    std::size_t i = 0;
+
+#if defined(AST_PARTICLES_SSE)
+    const __m128 dtV = _mm_set1_ps(dt);
+    const __m128 dampingV = _mm_set1_ps(damping);
+    const __m128 accelerationXV = _mm_set1_ps(accelerationX);
+    const __m128 accelerationYV = _mm_set1_ps(accelerationY);
+    for (; i < size_; i += SIMD_WIDTH) {
+        const __m128 vx =
+            _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&velocityX_[i]), accelerationXV), dampingV);
+        const __m128 vy =
+            _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&velocityY_[i]), accelerationYV), dampingV);
+        _mm_storeu_ps(&velocityX_[i], vx);
+        _mm_storeu_ps(&velocityY_[i], vy);
+        _mm_storeu_ps(&x_[i], _mm_add_ps(_mm_loadu_ps(&x_[i]), _mm_mul_ps(vx, dtV)));
+        _mm_storeu_ps(&y_[i], _mm_add_ps(_mm_loadu_ps(&y_[i]), _mm_mul_ps(vy, dtV)));
+        const __m128 age = _mm_add_ps(_mm_loadu_ps(&age_[i]), dtV);
+        _mm_storeu_ps(&age_[i], age);
+        anyDead |= _mm_movemask_ps(_mm_cmpge_ps(age, _mm_loadu_ps(&lifetime_[i]))) != 0;
+    }
+#elif defined(AST_PARTICLES_NEON)
+    const float32x4_t dtV = vdupq_n_f32(dt);
+    const float32x4_t dampingV = vdupq_n_f32(damping);
+    const float32x4_t accelerationXV = vdupq_n_f32(accelerationX);
+    const float32x4_t accelerationYV = vdupq_n_f32(accelerationY);
+    for (; i < size_; i += SIMD_WIDTH) {
+        const float32x4_t vx =
+            vmulq_f32(vaddq_f32(vld1q_f32(&velocityX_[i]), accelerationXV), dampingV);
+        const float32x4_t vy =
+            vmulq_f32(vaddq_f32(vld1q_f32(&velocityY_[i]), accelerationYV), dampingV);
+        vst1q_f32(&velocityX_[i], vx);
+        vst1q_f32(&velocityY_[i], vy);
+        vst1q_f32(&x_[i], vfmaq_f32(vld1q_f32(&x_[i]), vx, dtV));
+        vst1q_f32(&y_[i], vfmaq_f32(vld1q_f32(&y_[i]), vy, dtV));
+        const float32x4_t age = vaddq_f32(vld1q_f32(&age_[i]), dtV);
+        vst1q_f32(&age_[i], age);
+        anyDead |= vmaxvq_u32(vcgeq_f32(age, vld1q_f32(&lifetime_[i]))) != 0;
+    }
+#else
+    for (; i < size_; ++i) {
+        velocityX_[i] = (velocityX_[i] + accelerationX) * damping;
+        velocityY_[i] = (velocityY_[i] + accelerationY) * damping;
+        x_[i] += velocityX_[i] * dt;
+        y_[i] += velocityY_[i] * dt;
+        age_[i] += dt;
+        anyDead |= age_[i] >= lifetime_[i];
+    }
+#endif
+
+    if (!anyDead) {
+        return 0;
+    }
+    const std::size_t before = size_;
+    for (std::size_t j = 0; j < size_;) {
+        if (age_[j] >= lifetime_[j]) {
+            remove(j);
+        } else {
+            ++j;
+        }
+    }
+    return before - size_;
+}
+
+void ParticlePool::clear() {
+    std::fill(lifetime_.begin(), lifetime_.begin() + size_, NEVER);
+    size_ = 0;
+}
+
+void ParticlePool::remove(std::size_t index) {
+    const std::size_t last = --size_;
+    x_[index] = x_[last];
+    y_[index] = y_[last];
+    velocityX_[index] = velocityX_[last];
+    velocityY_[index] = velocityY_[last];
+    age_[index] = age_[last];
+    lifetime_[index] = lifetime_[last];
+    particleSize_[index] = particleSize_[last];
+    startColor_[index] = startColor_[last];
+    endColor_[index] = endColor_[last];
+    lifetime_[last] = NEVER;
+}
+
+ParticleSystem::ParticleSystem(Registry& registry, std::size_t capacity)
+    : System(registry), pool_(capacity) {}
+
+void ParticleSystem::update(float dt) {
+    AST_PROFILE_FUNCTION();
+    stats_.died = pool_.update(dt, acceleration_, drag_);
+    stats_.dropped = 0;
+
+    const std::size_t survivors = pool_.size();
+    auto& emitters = registry_.getAll<ParticleEmitter>();
+    for (Entity entity : entities_) {
+        ParticleEmitter& emitter = emitters.getUnchecked(entity);
+        int count = std::exchange(emitter.burst, 0);
+        if (emitter.emitting && emitter.rate > 0.0f) {
+            emitter.pending += emitter.rate * dt;
+            const auto whole = static_cast<int>(emitter.pending);
+            emitter.pending -= static_cast<float>(whole);
+            count += whole;
+        }
+        emit(emitter, count);
+    }
+    stats_.spawned = pool_.size() - survivors;
+    stats_.alive = pool_.size();
+}
+
+void ParticleSystem::emit(const ParticleEmitter& emitter, int count) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    constexpr float DEGREES_TO_RADIANS = std::numbers::pi_v<float> / 180.0f;
+    for (int i = 0; i < count; ++i) {
+        const float angle =
+            (emitter.direction + (unit(random_) - 0.5f) * emitter.spread) * DEGREES_TO_RADIANS;
+        const float speed =
+            emitter.minSpeed + (emitter.maxSpeed - emitter.minSpeed) * unit(random_);
+        const ParticleSpawn spawn{
+            .position = emitter.position,
+            .velocity = Vector2(std::cos(angle), std::sin(angle)) * speed,
+            .lifetime = emitter.minLifetime +
+                        (emitter.maxLifetime - emitter.minLifetime) * unit(random_),
+            .size = emitter.size,
+            .startColor = emitter.startColor,
+            .endColor = emitter.endColor,
+        };
+        if (!pool_.spawn(spawn)) {
+            stats_.dropped += static_cast<std::size_t>(count - i);
+            return;
+        }
+    }
+}
+
+void ParticleSystem::draw(SDL_Renderer* renderer, const Camera* camera) {
+    AST_PROFILE_FUNCTION();
+    const std::size_t count = pool_.size();
+    if (count == 0) {
+        return;
+    }
+    const Texture& texture = Cache::getTexture(texture_);
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 1.0f;
+    float v1 = 1.0f;
+    if (texture.handle) {
+        float width = 1.0f;
+        float height = 1.0f;
+        if (!SDL_GetTextureSize(texture.handle, &width, &height)) {
+            SDL_ERROR();
+        }
+        u0 = texture.source.x / width;
+        v0 = texture.source.y / height;
+        u1 = (texture.source.x + texture.source.w) / width;
+        v1 = (texture.source.y + texture.source.h) / height;
+    }
+
+    const float zoom = camera ? camera->zoom : 1.0f;
+    const float* xs = pool_.getX();
+    const float* ys = pool_.getY();
+    const float* ages = pool_.getAge();
+    const float* lifetimes = pool_.getLifetime();
+    const float* sizes = pool_.getSize();
+    const Color* startColors = pool_.getStartColor();
+    const Color* endColors = pool_.getEndColor();
+    vertices_.resize(count * 4);
+    for (std::size_t i = 0; i < count; ++i) {
+        const Vector2 center =
+            camera ? camera->worldToScreen(Vector2(xs[i], ys[i])) : Vector2(xs[i], ys[i]);
+        const float half = sizes[i] * zoom * 0.5f;
+        // Particles spawned this update with no lifetime would otherwise divide 0 by 0
+        const float t = lifetimes[i] > 0.0f ? std::min(ages[i] / lifetimes[i], 1.0f) : 1.0f;
+        const Color& start = startColors[i];
+        const Color& end = endColors[i];
+        const SDL_FColor color{(start.r + (end.r - start.r) * t) / 255.0f,
+                               (start.g + (end.g - start.g) * t) / 255.0f,
+                               (start.b + (end.b - start.b) * t) / 255.0f,
+                               (start.a + (end.a - start.a) * t) / 255.0f};
+        SDL_Vertex* quad = &vertices_[i * 4];
+        quad[0] = {{center.x - half, center.y - half}, color, {u0, v0}};
+        quad[1] = {{center.x + half, center.y - half}, color, {u1, v0}};
+        quad[2] = {{center.x + half, center.y + half}, color, {u1, v1}};
+        quad[3] = {{center.x - half, center.y + half}, color, {u0, v1}};
+    }
+
+    indices_.draw(renderer, texture.handle, vertices_.data(), count);
+}
+
+}  // namespace ast
@@ -0,0 +1,180 @@
+#include "asteroid/PositionalAudio.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define AST_SPATIAL_SSE
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define AST_SPATIAL_NEON
+#endif
+
+namespace ast {
+
+PositionalAudioSystem::PositionalAudioSystem(Registry& registry, std::size_t maxVoices)
+    : System(registry), maxVoices_(maxVoices) {}
+
+void PositionalAudioSystem::update(float dt) {
+    Audio& audio = Audio::getInstance();
+    auto& emitters = registry_.getAll<AudioEmitter>();
+    const std::size_t count = entities_.size();
+
+    x_.resize(count);
+    y_.resize(count);
+    minDistance_.resize(count);
+    inverseRange_.resize(count);
+    emitterGain_.resize(count);
+    gains_.resize(count);
+    pans_.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const AudioEmitter& emitter = emitters.getUnchecked(entities_[i]);
+        x_[i] = emitter.position.x;
+        y_[i] = emitter.position.y;
+        minDistance_[i] = emitter.minDistance;
+        inverseRange_[i] = 1.0f / std::max(emitter.maxDistance - emitter.minDistance, 1e-3f);
+        emitterGain_[i] = emitter.gain;
+    }
+    computeGainAndPan(getListenerPosition());
+
+    // Emitters that want a voice: audible and either continuous, triggered or still playing
+    audible_.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        AudioEmitter& emitter = emitters.getUnchecked(entities_[i]);
+        emitter.audibleGain = gains_[i];
+        emitter.pan = pans_[i];
+        if (emitter.voice != NULL_VOICE_ID && !audio.isVoicePlaying(emitter.voice)) {
+            emitter.voice = NULL_VOICE_ID;
+        }
+        bool wanted =
+            emitter.loops == 0 || emitter.triggered || emitter.voice != NULL_VOICE_ID;
+        if (wanted && gains_[i] > threshold_) {
+            audible_.push_back(i);
+        }
+    }
+    stats_.emitters = count;
+    stats_.audible = audible_.size();
+    stats_.culled = 0;
+
+    // Keep the loudest emitters within the voice budget
+    if (audible_.size() > maxVoices_) {
+        std::nth_element(audible_.begin(), audible_.begin() + maxVoices_, audible_.end(),
+                         [this](std::size_t a, std::size_t b) { return gains_[a] > gains_[b]; });
+        stats_.culled = audible_.size() - maxVoices_;
+        audible_.resize(maxVoices_);
+    }
+    std::sort(audible_.begin(), audible_.end());
+
+    updates_.clear();
+    stats_.playing = 0;
+    auto next = audible_.begin();
+    for (std::size_t i = 0; i < count; ++i) {
+        AudioEmitter& emitter = emitters.getUnchecked(entities_[i]);
+        const bool selected = next != audible_.end() && *next == i;
+        if (selected) {
+            ++next;
+        }
+        if (!selected) {
+            if (emitter.voice != NULL_VOICE_ID) {
+                audio.stopVoice(emitter.voice);
+                emitter.voice = NULL_VOICE_ID;
+            }
+        } else if (emitter.voice == NULL_VOICE_ID || emitter.triggered) {
+            if (emitter.voice != NULL_VOICE_ID) {
+                audio.stopVoice(emitter.voice);
+            }
+            Audio::VoiceParams params;
+            params.gain = gains_[i];
+            params.pan = pans_[i];
+            params.priority = emitter.priority;
+            params.loops = emitter.loops;
+            emitter.voice = audio.playSound(emitter.sound, params);
+            if (emitter.voice != NULL_VOICE_ID) {
+                ++stats_.playing;
+            }
+        } else {
+            updates_.push_back({emitter.voice, gains_[i], pans_[i]});
+            ++stats_.playing;
+        }
+        emitter.triggered = false;
+    }
+
+    if (!updates_.empty()) {
+        audio.updateVoices(updates_);
+    }
+}
+
+void PositionalAudioSystem::onEntityRemoved(Entity entity) {
+    if (AudioEmitter* emitter = registry_.get<AudioEmitter>(entity)) {
+        if (emitter->voice != NULL_VOICE_ID) {
+            Audio::getInstance().stopVoice(emitter->voice);
+            emitter->voice = NULL_VOICE_ID;
+        }
+    }
+}
+
+Vector2 PositionalAudioSystem::getListenerPosition() const {
+    const auto& listeners = registry_.getAll<AudioListener>();
+    if (listener_ != NULL_ENTITY) {
+        if (const AudioListener* listener = listeners.get(listener_)) {
+            return listener->position;
+        }
+    }
+    return listeners.empty() ? Vector2{} : listeners.components().front().position;
+}
+
+void PositionalAudioSystem::computeGainAndPan(Vector2 listener) {
+    const std::size_t count = x_.size();
+    std::size_t i = 0;
+#if defined(AST_SPATIAL_SSE)
+    const __m128 lx = _mm_set1_ps(listener.x);
+    const __m128 ly = _mm_set1_ps(listener.y);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&x_[i]), lx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&y_[i]), ly);
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+        __m128 minDistance = _mm_loadu_ps(&minDistance_[i]);
+        __m128 fade =
+            _mm_mul_ps(_mm_sub_ps(distance, minDistance), _mm_loadu_ps(&inverseRange_[i]));
+        __m128 attenuation = _mm_min_ps(one, _mm_max_ps(zero, _mm_sub_ps(one, fade)));
+        _mm_storeu_ps(&gains_[i], _mm_mul_ps(attenuation, _mm_loadu_ps(&emitterGain_[i])));
+        // Sideways component of the direction, softened inside minDistance
+        __m128 pan = _mm_div_ps(dx, _mm_max_ps(distance, _mm_max_ps(minDistance, one)));
+        _mm_storeu_ps(&pans_[i], _mm_min_ps(one, _mm_max_ps(minusOne, pan)));
+    }
+#elif defined(AST_SPATIAL_NEON)
+    const float32x4_t lx = vdupq_n_f32(listener.x);
+    const float32x4_t ly = vdupq_n_f32(listener.y);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t minusOne = vdupq_n_f32(-1.0f);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t dx = vsubq_f32(vld1q_f32(&x_[i]), lx);
+        float32x4_t dy = vsubq_f32(vld1q_f32(&y_[i]), ly);
+        float32x4_t distance = vsqrtq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy));
+        float32x4_t minDistance = vld1q_f32(&minDistance_[i]);
+        float32x4_t fade =
+            vmulq_f32(vsubq_f32(distance, minDistance), vld1q_f32(&inverseRange_[i]));
+        float32x4_t attenuation = vminq_f32(one, vmaxq_f32(zero, vsubq_f32(one, fade)));
+        vst1q_f32(&gains_[i], vmulq_f32(attenuation, vld1q_f32(&emitterGain_[i])));
+        float32x4_t pan = vdivq_f32(dx, vmaxq_f32(distance, vmaxq_f32(minDistance, one)));
+        vst1q_f32(&pans_[i], vminq_f32(one, vmaxq_f32(minusOne, pan)));
+    }
+#endif
+    for (; i < count; ++i) {
+        float dx = x_[i] - listener.x;
+        float dy = y_[i] - listener.y;
+        float distance = std::sqrt(dx * dx + dy * dy);
+        float attenuation =
+            std::clamp(1.0f - (distance - minDistance_[i]) * inverseRange_[i], 0.0f, 1.0f);
+        gains_[i] = attenuation * emitterGain_[i];
+        float pan = dx / std::max(distance, std::max(minDistance_[i], 1.0f));
+        pans_[i] = std::clamp(pan, -1.0f, 1.0f);
+    }
+}
+
+}  // namespace ast
@@ -0,0 +1,212 @@
+#include "asteroid/Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+namespace ast {
+
+namespace {
+
+constexpr std::uint64_t EVENT_MASK = Profiler::EVENTS_PER_THREAD - 1;
+static_assert((Profiler::EVENTS_PER_THREAD & EVENT_MASK) == 0,
+              "EVENTS_PER_THREAD must be a power of two");
+
+// A ring slot. The exporting thread may read a slot while its thread overwrites it; such
+// events are discarded, and relaxed atomics keep the concurrent access well defined.
+struct EventSlot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<std::uint64_t> start{0};
+    std::atomic<std::uint64_t> end{0};
+};
+
+// Written only by its thread; read by the exporting thread
+struct ThreadBuffer {
+    explicit ThreadBuffer(std::uint32_t id) : id(id), events(Profiler::EVENTS_PER_THREAD) {}
+
+    std::uint32_t id;
+    std::string name;  // Guarded by the registry mutex
+    std::vector<EventSlot> events;
+    std::atomic<std::uint64_t> written{0};
+    // Events before this index were discarded by clear()
+    std::atomic<std::uint64_t> cleared{0};
+    // Set when the thread ends; clear() then frees the buffer
+    std::atomic<bool> exited{false};
+};
+
+// Registers the calling thread's buffer and marks it exited when the thread ends
+struct ThreadBufferOwner {
+    ThreadBufferOwner();
+    ~ThreadBufferOwner() { buffer->exited.store(true, std::memory_order_relaxed); }
+    ThreadBufferOwner(const ThreadBufferOwner&) = delete;
+    ThreadBufferOwner& operator=(const ThreadBufferOwner&) = delete;
+
+    std::shared_ptr<ThreadBuffer> buffer;
+};
+
+struct ThreadRegistry {
+    std::mutex mutex;
+    // Kept after their threads exit so that their zones can still be exported, until the
+    // next clear()
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::unordered_map<std::type_index, std::string> typeNames;
+    std::uint32_t nextId = 1;
+};
+
+ThreadRegistry& getRegistry() {
+    static ThreadRegistry registry;
+    return registry;
+}
+
+ThreadBufferOwner::ThreadBufferOwner() {
+    ThreadRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    buffer = std::make_shared<ThreadBuffer>(registry.nextId++);
+    registry.buffers.push_back(buffer);
+}
+
+ThreadBuffer& getThreadBuffer() {
+    thread_local ThreadBufferOwner owner;
+    return *owner.buffer;
+}
+
+const std::chrono::steady_clock::time_point EPOCH = std::chrono::steady_clock::now();
+std::atomic<bool> enabled{true};
+
+}  // namespace
+
+std::uint64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                EPOCH)
+        .count();
+}
+
+void Profiler::record(const char* name, std::uint64_t start, std::uint64_t end) {
+    if (!enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    EventSlot& slot = buffer.events[index & EVENT_MASK];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setEnabled(bool value) { enabled.store(value, std::memory_order_relaxed); }
+
+bool Profiler::isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+void Profiler::setThreadName(const char* name) {
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(getRegistry().mutex);
+    buffer.name = name;
+}
+
+const char* Profiler::getTypeName(const std::type_info& type) {
+    ThreadRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto [it, inserted] = registry.typeNames.try_emplace(type, type.name());
+#if defined(__GNUC__)
+    if (inserted) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        if (status == 0) {
+            it->second = demangled;
+        }
+        std::free(demangled);
+    }
+#endif
+    return it->second.c_str();
+}
+
+void Profiler::clear() {
+    ThreadRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    // Nothing is left to export from threads that have ended
+    std::erase_if(registry.buffers, [](const auto& buffer) {
+        return buffer->exited.load(std::memory_order_relaxed);
+    });
+    for (const auto& buffer : registry.buffers) {
+        buffer->cleared.store(buffer->written.load(std::memory_order_acquire),
+                              std::memory_order_relaxed);
+    }
+}
+
+std::size_t Profiler::getThreadBufferCount() {
+    ThreadRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.buffers.size();
+}
+
+bool Profiler::exportChromeTrace(const std::filesystem::path& path) {
+    nlohmann::json events = nlohmann::json::array();
+    std::vector<Event> copied;
+    std::size_t eventCount = 0;
+    {
+        ThreadRegistry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& buffer : registry.buffers) {
+            const std::uint64_t end = buffer->written.load(std::memory_order_acquire);
+            std::uint64_t begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+            begin = std::max(begin, buffer->cleared.load(std::memory_order_relaxed));
+            copied.clear();
+            for (std::uint64_t i = begin; i < end; ++i) {
+                const EventSlot& slot = buffer->events[i & EVENT_MASK];
+                copied.push_back({slot.name.load(std::memory_order_relaxed),
+                                  slot.start.load(std::memory_order_relaxed),
+                                  slot.end.load(std::memory_order_relaxed)});
+            }
+            // The thread kept recording during the copy; drop the slots it may have reused,
+            // including the one it may be writing now
+            const std::uint64_t after = buffer->written.load(std::memory_order_acquire);
+            const std::uint64_t valid =
+                after + 1 > EVENTS_PER_THREAD ? after + 1 - EVENTS_PER_THREAD : 0;
+            const std::size_t skipped = valid > begin ? std::min(valid - begin, end - begin) : 0;
+
+            const std::string name =
+                buffer->name.empty() ? "Thread " + std::to_string(buffer->id) : buffer->name;
+            events.push_back({{"name", "thread_name"},
+                              {"ph", "M"},
+                              {"pid", 1},
+                              {"tid", buffer->id},
+                              {"args", {{"name", name}}}});
+            for (std::size_t i = skipped; i < copied.size(); ++i) {
+                const Event& event = copied[i];
+                events.push_back({{"name", event.name},
+                                  {"ph", "X"},
+                                  {"pid", 1},
+                                  {"tid", buffer->id},
+                                  {"ts", event.start / 1000.0},
+                                  {"dur", (event.end - event.start) / 1000.0}});
+                ++eventCount;
+            }
+        }
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        AST_ERROR("Cannot write trace to {}", path.string());
+        return false;
+    }
+    file << nlohmann::json{{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}};
+    AST_INFO("Exported {} profiler zones to {}", eventCount, path.string());
+    return true;
+}
+
+}  // namespace ast
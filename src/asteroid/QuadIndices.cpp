@@ -0,0 +1,24 @@
+#include "asteroid/QuadIndices.hpp"
+
+namespace ast {
+
+void QuadIndices::draw(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Vertex* vertices,
+                       std::size_t quadCount) {
+    if (quadCount == 0) {
+        return;
+    }
+    if (indices_.size() < quadCount * 6) {
+        indices_.reserve(quadCount * 6);
+        for (std::size_t i = indices_.size() / 6; i < quadCount; ++i) {
+            const int first = static_cast<int>(i * 4);
+            indices_.insert(indices_.end(),
+                            {first, first + 1, first + 2, first + 2, first + 3, first});
+        }
+    }
+    if (!SDL_RenderGeometry(renderer, texture, vertices, static_cast<int>(quadCount * 4),
+                            indices_.data(), static_cast<int>(quadCount * 6))) {
+        SDL_ERROR();
+    }
+}
+
+}  // namespace ast
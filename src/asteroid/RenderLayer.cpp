@@ -0,0 +1,89 @@
+#include "asteroid/RenderLayer.hpp"
+
+#include "asteroid/Profiler.hpp"
+
+namespace ast {
+
+RenderLayer::RenderLayer(DrawFunction draw, bool isStatic)
+    : draw_(std::move(draw)), static_(isStatic) {}
+
+RenderLayer::~RenderLayer() { releaseCache(); }
+
+void RenderLayer::setStatic(bool isStatic) {
+    static_ = isStatic;
+    if (!static_) {
+        releaseCache();
+    }
+}
+
+void RenderLayer::render(SDL_Renderer* renderer) {
+    if (!static_) {
+        draw_(renderer);
+        return;
+    }
+
+    int width = 0;
+    int height = 0;
+    if (!SDL_GetRenderLogicalPresentation(renderer, &width, &height, nullptr) || width == 0) {
+        // Without a logical presentation, render coordinates are output pixels
+        SDL_GetCurrentRenderOutputSize(renderer, &width, &height);
+    }
+    if (!prepareCache(renderer, width, height)) {
+        draw_(renderer);
+        return;
+    }
+
+    if (!valid_) {
+        AST_PROFILE_ZONE("RenderLayer::redraw");
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+        Uint8 r = 0;
+        Uint8 g = 0;
+        Uint8 b = 0;
+        Uint8 a = 0;
+        SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+        SDL_SetRenderTarget(renderer, cache_);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+        draw_(renderer);
+        SDL_SetRenderTarget(renderer, previousTarget);
+        valid_ = true;
+        ++redrawCount_;
+    }
+    if (!SDL_RenderTexture(renderer, cache_, nullptr, nullptr)) {
+        SDL_ERROR();
+    }
+}
+
+bool RenderLayer::prepareCache(SDL_Renderer* renderer, int width, int height) {
+    if (cache_ && width == cacheWidth_ && height == cacheHeight_) {
+        return true;
+    }
+    releaseCache();
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    cache_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+                               width, height);
+    if (!cache_) {
+        SDL_ERROR();
+        return false;
+    }
+    // Blending onto the transparent cache leaves colors multiplied by their alpha, so the
+    // cache is composited as premultiplied to come out as if drawn directly
+    SDL_SetTextureBlendMode(cache_, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+    cacheWidth_ = width;
+    cacheHeight_ = height;
+    valid_ = false;
+    return true;
+}
+
+void RenderLayer::releaseCache() {
+    if (cache_) {
+        SDL_DestroyTexture(cache_);
+        cache_ = nullptr;
+    }
+    valid_ = false;
+}
+
+}  // namespace ast
@@ -0,0 +1,132 @@
+#include "asteroid/RenderQueue.hpp"
+
+#include <array>
+#include <bit>
+
+#include "asteroid/Cache.hpp"
+#include "asteroid/Profiler.hpp"
+#include "asteroid/SpriteBatch.hpp"
+
+namespace ast {
+
+namespace {
+
+constexpr std::uint64_t TEXTURE_MASK = (1u << 24) - 1;
+
+}  // namespace
+
+std::uint64_t RenderQueue::makeKey(int layer, TextureId texture, float depth) {
+    const auto biasedLayer =
+        static_cast<std::uint64_t>(std::clamp(layer, -32768, 32767) + 32768);
+    const std::uint64_t textureBits = std::min<std::uint64_t>(texture, TEXTURE_MASK);
+    // Flip the bits of negative floats and the sign of positive ones, so that the bits
+    // compare as unsigned integers in the same order as the floats
+    auto depthBits = std::bit_cast<std::uint32_t>(depth);
+    depthBits = (depthBits & 0x80000000u) ? ~depthBits : depthBits | 0x80000000u;
+    return biasedLayer << 48 | textureBits << 24 | depthBits >> 8;
+}
+
+RenderQueue::Buffer& RenderQueue::getBuffer() {
+    struct CachedBuffer {
+        std::uint64_t queueId = 0;
+        Buffer* buffer = nullptr;
+    };
+    thread_local CachedBuffer cached;
+    if (cached.queueId != id_) {
+        cached = {id_, &findBuffer()};
+    }
+    return *cached.buffer;
+}
+
+RenderQueue::Buffer& RenderQueue::findBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = bufferIndices_.try_emplace(std::this_thread::get_id(), buffers_.size());
+    if (inserted) {
+        buffers_.push_back(std::make_unique<Buffer>());
+    }
+    return *buffers_[it->second];
+}
+
+std::size_t RenderQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t count = 0;
+    for (const auto& buffer : buffers_) {
+        count += buffer->size();
+    }
+    return count;
+}
+
+const std::vector<const RenderCommand*>& RenderQueue::sort() {
+    AST_PROFILE_FUNCTION();
+    entries_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& buffer : buffers_) {
+            for (const RenderCommand& command : buffer->commands_) {
+                entries_.push_back({command.key, &command});
+            }
+        }
+    }
+
+    // LSD radix sort, one byte per pass. Counting every byte in one sweep lets passes
+    // where all keys share the byte be skipped, which is most of them for typical keys.
+    std::array<std::array<std::size_t, 256>, 8> counts{};
+    for (const Entry& entry : entries_) {
+        for (int pass = 0; pass < 8; ++pass) {
+            ++counts[pass][(entry.key >> (pass * 8)) & 0xFF];
+        }
+    }
+    scratch_.resize(entries_.size());
+    for (int pass = 0; pass < 8; ++pass) {
+        std::array<std::size_t, 256>& count = counts[pass];
+        const int shift = pass * 8;
+        if (entries_.empty() ||
+            count[(entries_.front().key >> shift) & 0xFF] == entries_.size()) {
+            continue;
+        }
+        std::size_t offset = 0;
+        for (std::size_t& bucket : count) {
+            offset += std::exchange(bucket, offset);
+        }
+        for (const Entry& entry : entries_) {
+            scratch_[count[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        entries_.swap(scratch_);
+    }
+
+    sorted_.clear();
+    sorted_.reserve(entries_.size());
+    for (const Entry& entry : entries_) {
+        sorted_.push_back(entry.command);
+    }
+    return sorted_;
+}
+
+void RenderQueue::execute(SpriteBatch& batch) {
+    AST_PROFILE_FUNCTION();
+    for (const RenderCommand* command : sort()) {
+        const Texture& texture = Cache::getTexture(command->texture);
+        if (!texture.handle) {
+            continue;
+        }
+        Rect source = texture.source;
+        if (command->source.w > 0.0f && command->source.h > 0.0f) {
+            source = Rect{texture.source.x + command->source.x,
+                          texture.source.y + command->source.y, command->source.w,
+                          command->source.h};
+        }
+        batch.draw(texture.handle, source, command->destination, command->rotation,
+                   command->color);
+    }
+    batch.flushUnsorted();
+    clear();
+}
+
+void RenderQueue::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& buffer : buffers_) {
+        buffer->commands_.clear();
+    }
+}
+
+}  // namespace ast
@@ -0,0 +1,111 @@
+#include "asteroid/SpriteBatch.hpp"
+
+#include <cmath>
+#include <numbers>
+
+#include "asteroid/Profiler.hpp"
+
+namespace ast {
+
+void SpriteBatch::draw(SDL_Texture* texture, const Rect& source, const Rect& destination,
+                       float rotation, Color color, int layer) {
+    sprites_.push_back({texture, source, destination, rotation, color, layer,
+                        static_cast<std::uint32_t>(sprites_.size())});
+}
+
+void SpriteBatch::flush() {
+    AST_PROFILE_FUNCTION();
+    std::sort(sprites_.begin(), sprites_.end(), [](const Sprite& lhs, const Sprite& rhs) {
+        if (lhs.layer != rhs.layer) {
+            return lhs.layer < rhs.layer;
+        }
+        if (lhs.texture != rhs.texture) {
+            return std::less<SDL_Texture*>()(lhs.texture, rhs.texture);
+        }
+        return lhs.order < rhs.order;
+    });
+    submit();
+}
+
+void SpriteBatch::flushUnsorted() {
+    AST_PROFILE_FUNCTION();
+    submit();
+}
+
+void SpriteBatch::submit() {
+    stats_ = {sprites_.size(), 0};
+    if (sprites_.empty()) {
+        return;
+    }
+    if (!renderer_) {
+        AST_WARN("SpriteBatch has no renderer, dropping {} sprite(s)", sprites_.size());
+        sprites_.clear();
+        return;
+    }
+
+    vertices_.clear();
+    vertices_.reserve(sprites_.size() * 4);
+    std::size_t runStart = 0;
+    while (runStart < sprites_.size()) {
+        const int layer = sprites_[runStart].layer;
+        SDL_Texture* texture = sprites_[runStart].texture;
+        float textureWidth = 1.0f;
+        float textureHeight = 1.0f;
+        if (texture && !SDL_GetTextureSize(texture, &textureWidth, &textureHeight)) {
+            SDL_ERROR();
+        }
+
+        std::size_t runEnd = runStart;
+        for (; runEnd < sprites_.size() && sprites_[runEnd].texture == texture &&
+               sprites_[runEnd].layer == layer;
+             ++runEnd) {
+            appendQuad(sprites_[runEnd], textureWidth, textureHeight);
+        }
+
+        indices_.draw(renderer_, texture, vertices_.data() + runStart * 4, runEnd - runStart);
+        ++stats_.drawCalls;
+        runStart = runEnd;
+    }
+    sprites_.clear();
+}
+
+void SpriteBatch::appendQuad(const Sprite& sprite, float textureWidth, float textureHeight) {
+    const Rect& dst = sprite.destination;
+    const SDL_FColor color{sprite.color.r / 255.0f, sprite.color.g / 255.0f,
+                           sprite.color.b / 255.0f, sprite.color.a / 255.0f};
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 1.0f;
+    float v1 = 1.0f;
+    if (sprite.texture) {
+        u0 = sprite.source.x / textureWidth;
+        v0 = sprite.source.y / textureHeight;
+        u1 = (sprite.source.x + sprite.source.w) / textureWidth;
+        v1 = (sprite.source.y + sprite.source.h) / textureHeight;
+    }
+
+    // Corners clockwise from the top left, relative to the center
+    const float halfW = dst.w * 0.5f;
+    const float halfH = dst.h * 0.5f;
+    const float cx = dst.x + halfW;
+    const float cy = dst.y + halfH;
+    const float corners[4][2] = {{-halfW, -halfH}, {halfW, -halfH}, {halfW, halfH}, {-halfW, halfH}};
+    const float uvs[4][2] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+    float cosine = 1.0f;
+    float sine = 0.0f;
+    if (sprite.rotation != 0.0f) {
+        const float radians = sprite.rotation * (std::numbers::pi_v<float> / 180.0f);
+        cosine = std::cos(radians);
+        sine = std::sin(radians);
+    }
+    for (int i = 0; i < 4; ++i) {
+        const float x = corners[i][0];
+        const float y = corners[i][1];
+        vertices_.push_back({{cx + x * cosine - y * sine, cy + x * sine + y * cosine},
+                             color,
+                             {uvs[i][0], uvs[i][1]}});
+    }
+}
+
+}  // namespace ast
@@ -0,0 +1,171 @@
+#include "asteroid/StreamingSound.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#define MINIMP3_ONLY_MP3
+#include "minimp3.h"
+
+#include "asteroid/AssetPack.hpp"
+
+namespace ast {
+
+namespace {
+
+// Compressed input kept buffered; more than the largest MP3 frame
+constexpr std::size_t INPUT_SIZE = 16 * 1024;
+constexpr std::size_t MAX_FRAME_BYTES = 4096;
+// Frames converted per call to SDL_GetAudioStreamData()
+constexpr std::size_t SCRATCH_FRAMES = 1024;
+
+}  // namespace
+
+struct StreamingSound::Decoder {
+    mp3dec_t mp3;
+    mp3d_sample_t pcm[MINIMP3_MAX_SAMPLES_PER_FRAME];
+    SDL_AudioSpec format{};
+};
+
+StreamingSound::StreamingSound(SDL_IOStream* io, const SDL_AudioSpec& spec,
+                               std::size_t bufferFrames, int loops)
+    : io_(io),
+      decoder_(std::make_unique<Decoder>()),
+      spec_(spec),
+      ring_(bufferFrames * spec.channels),
+      input_(INPUT_SIZE),
+      scratch_(SCRATCH_FRAMES * spec.channels),
+      loops_(loops) {
+    mp3dec_init(&decoder_->mp3);
+}
+
+StreamingSound::~StreamingSound() {
+    SDL_DestroyAudioStream(converter_);
+    SDL_CloseIO(io_);
+}
+
+std::shared_ptr<StreamingSound> StreamingSound::open(const std::filesystem::path& path,
+                                                     const SDL_AudioSpec& spec,
+                                                     std::size_t bufferFrames, int loops) {
+    SDL_IOStream* io = AssetPack::openIO(path);
+    if (!io) {
+        SDL_ERROR();
+        return nullptr;
+    }
+    return std::shared_ptr<StreamingSound>(new StreamingSound(io, spec, bufferFrames, loops));
+}
+
+bool StreamingSound::decode() {
+    if (finished_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    const std::size_t channels = spec_.channels;
+    const int frameSize = SDL_AUDIO_FRAMESIZE(spec_);
+    bool produced = false;
+
+    while (std::size_t freeFrames = ring_.getFreeSpace() / channels) {
+        int available = converter_ ? SDL_GetAudioStreamAvailable(converter_) / frameSize : 0;
+        if (available > 0) {
+            std::size_t count = std::min({freeFrames, static_cast<std::size_t>(available),
+                                          SCRATCH_FRAMES});
+            int bytes = SDL_GetAudioStreamData(converter_, scratch_.data(),
+                                               static_cast<int>(count) * frameSize);
+            if (bytes <= 0) {
+                break;
+            }
+            ring_.write(scratch_.data(), static_cast<std::size_t>(bytes) / sizeof(float));
+            produced = true;
+        } else if (!decodeEnded_) {
+            if (decodeFrame()) {
+                continue;
+            }
+            // Loop from the start unless this was the last pass or the file has no audio
+            if (loops_ != 1 && framesSinceRewind_ > 0 && rewind()) {
+                if (loops_ > 0) {
+                    --loops_;
+                }
+                continue;
+            }
+            decodeEnded_ = true;
+            if (converter_) {
+                SDL_FlushAudioStream(converter_);
+            }
+        } else {
+            finished_.store(true, std::memory_order_release);
+            break;
+        }
+    }
+    return produced;
+}
+
+std::size_t StreamingSound::read(float* out, std::size_t frameCount) {
+    const std::size_t channels = spec_.channels;
+    std::size_t frames = ring_.read(out, frameCount * channels) / channels;
+    if (frames < frameCount && !finished_.load(std::memory_order_acquire)) {
+        underruns_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return frames;
+}
+
+bool StreamingSound::isFinished() const {
+    return finished_.load(std::memory_order_acquire) && ring_.size() == 0;
+}
+
+bool StreamingSound::decodeFrame() {
+    Decoder& decoder = *decoder_;
+    for (;;) {
+        if (!fileEnded_ && inputSize_ - inputPosition_ < MAX_FRAME_BYTES) {
+            inputSize_ -= inputPosition_;
+            std::memmove(input_.data(), input_.data() + inputPosition_, inputSize_);
+            inputPosition_ = 0;
+            std::size_t read =
+                SDL_ReadIO(io_, input_.data() + inputSize_, input_.size() - inputSize_);
+            fileEnded_ = read == 0;
+            inputSize_ += read;
+        }
+        const std::size_t remaining = inputSize_ - inputPosition_;
+        if (remaining == 0) {
+            return false;
+        }
+
+        mp3dec_frame_info_t info{};
+        int samples = mp3dec_decode_frame(&decoder.mp3, input_.data() + inputPosition_,
+                                          static_cast<int>(remaining), decoder.pcm, &info);
+        // No frame in the buffered data: drop it
+        inputPosition_ += info.frame_bytes > 0 ? info.frame_bytes : remaining;
+        if (samples == 0) {
+            continue;  // Skipped tags or invalid data
+        }
+
+        if (info.channels != decoder.format.channels || info.hz != decoder.format.freq) {
+            decoder.format = {SDL_AUDIO_S16, info.channels, info.hz};
+            if (!converter_) {
+                converter_ = SDL_CreateAudioStream(&decoder.format, &spec_);
+            } else {
+                SDL_SetAudioStreamFormat(converter_, &decoder.format, nullptr);
+            }
+            if (!converter_) {
+                SDL_ERROR();
+                return false;
+            }
+        }
+        SDL_PutAudioStreamData(converter_, decoder.pcm,
+                               samples * info.channels * static_cast<int>(sizeof(mp3d_sample_t)));
+        ++framesSinceRewind_;
+        return true;
+    }
+}
+
+bool StreamingSound::rewind() {
+    if (SDL_SeekIO(io_, 0, SDL_IO_SEEK_SET) < 0) {
+        SDL_ERROR();
+        return false;
+    }
+    mp3dec_init(&decoder_->mp3);
+    inputSize_ = 0;
+    inputPosition_ = 0;
+    fileEnded_ = false;
+    framesSinceRewind_ = 0;
+    return true;
+}
+
+}  // namespace ast
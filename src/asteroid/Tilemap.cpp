@@ -0,0 +1,168 @@
+#include "asteroid/Tilemap.hpp"
+
+#include "asteroid/Cache.hpp"
+#include "asteroid/Profiler.hpp"
+
+namespace ast {
+
+Tilemap::Tilemap(int columns, int rows, TextureId tileset, int tileSize, int chunkSize)
+    : columns_(std::max(columns, 0)),
+      rows_(std::max(rows, 0)),
+      tileSize_(std::max(tileSize, 1)),
+      chunkSize_(std::max(chunkSize, 1)),
+      chunkColumns_((columns_ + chunkSize_ - 1) / chunkSize_),
+      chunkRows_((rows_ + chunkSize_ - 1) / chunkSize_),
+      tilesetId_(tileset),
+      tiles_(static_cast<std::size_t>(columns_) * rows_, EMPTY_TILE),
+      chunks_(static_cast<std::size_t>(chunkColumns_) * chunkRows_) {
+    setPosition({});
+}
+
+Tilemap::Tile Tilemap::getTile(int column, int row) const {
+    if (column < 0 || column >= columns_ || row < 0 || row >= rows_) {
+        return EMPTY_TILE;
+    }
+    return tiles_[static_cast<std::size_t>(row) * columns_ + column];
+}
+
+void Tilemap::setTile(int column, int row, Tile tile) {
+    if (column < 0 || column >= columns_ || row < 0 || row >= rows_) {
+        return;
+    }
+    Tile& current = tiles_[static_cast<std::size_t>(row) * columns_ + column];
+    if (current != tile) {
+        current = tile;
+        chunks_[(row / chunkSize_) * chunkColumns_ + column / chunkSize_].dirty = true;
+    }
+}
+
+void Tilemap::fill(Tile tile) {
+    std::fill(tiles_.begin(), tiles_.end(), tile);
+    markAllDirty();
+}
+
+void Tilemap::setPosition(Vector2 position) {
+    position_ = position;
+    chunkBounds_.clear();
+    const float chunkExtent = static_cast<float>(chunkSize_ * tileSize_);
+    for (int row = 0; row < chunkRows_; ++row) {
+        for (int column = 0; column < chunkColumns_; ++column) {
+            // Chunks on the right and bottom edges may be partial
+            const int tileColumns = std::min(chunkSize_, columns_ - column * chunkSize_);
+            const int tileRows = std::min(chunkSize_, rows_ - row * chunkSize_);
+            chunkBounds_.push_back(Rect{position_.x + column * chunkExtent,
+                                        position_.y + row * chunkExtent,
+                                        static_cast<float>(tileColumns * tileSize_),
+                                        static_cast<float>(tileRows * tileSize_)});
+        }
+    }
+}
+
+Rect Tilemap::getBounds() const {
+    return {position_, Vector2(static_cast<float>(columns_ * tileSize_),
+                               static_cast<float>(rows_ * tileSize_))};
+}
+
+void Tilemap::setTint(Color tint) { tint_ = tint; }
+
+void Tilemap::draw(SDL_Renderer* renderer, const Camera& camera) {
+    const Rect& viewport = camera.viewport;
+    const SDL_Rect clip{static_cast<int>(viewport.x), static_cast<int>(viewport.y),
+                        static_cast<int>(viewport.w), static_cast<int>(viewport.h)};
+    SDL_SetRenderClipRect(renderer, &clip);
+    draw(renderer, camera.getVisibleArea(), &camera);
+    SDL_SetRenderClipRect(renderer, nullptr);
+}
+
+void Tilemap::draw(SDL_Renderer* renderer, const Rect& view) { draw(renderer, view, nullptr); }
+
+void Tilemap::draw(SDL_Renderer* renderer, const Rect& view, const Camera* camera) {
+    AST_PROFILE_FUNCTION();
+    stats_ = {chunks_.size(), 0, 0, 0};
+    const Texture& tileset = Cache::getTexture(tilesetId_);
+    // An evicted and reloaded tileset may land elsewhere, invalidating the texture coordinates
+    if (tileset.handle != builtHandle_ || !(tileset.source == builtSource_)) {
+        markAllDirty();
+        builtHandle_ = tileset.handle;
+        builtSource_ = tileset.source;
+    }
+    Vector2 textureSize{1.0f, 1.0f};
+    if (tileset.handle && !SDL_GetTextureSize(tileset.handle, &textureSize.x, &textureSize.y)) {
+        SDL_ERROR();
+    }
+
+    visibleChunks_.clear();
+    stats_.visibleChunks = cullRects(chunkBounds_, view, visibleChunks_);
+
+    const float scale = camera ? camera->zoom : 1.0f;
+    const Vector2 origin = camera ? camera->worldToScreen(position_) : position_;
+    const SDL_FColor color{tint_.r / 255.0f, tint_.g / 255.0f, tint_.b / 255.0f,
+                           tint_.a / 255.0f};
+    vertices_.clear();
+    for (std::uint32_t index : visibleChunks_) {
+        Chunk& chunk = chunks_[index];
+        if (chunk.dirty) {
+            const int chunkIndex = static_cast<int>(index);
+            rebuild(chunkIndex % chunkColumns_, chunkIndex / chunkColumns_, tileset, textureSize);
+            ++stats_.rebuiltChunks;
+        }
+        for (const SDL_Vertex& vertex : chunk.vertices) {
+            vertices_.push_back({{origin.x + vertex.position.x * scale,
+                                  origin.y + vertex.position.y * scale},
+                                 color,
+                                 vertex.tex_coord});
+        }
+    }
+
+    const std::size_t quads = vertices_.size() / 4;
+    stats_.tiles = quads;
+    indices_.draw(renderer, tileset.handle, vertices_.data(), quads);
+}
+
+void Tilemap::rebuild(int chunkColumn, int chunkRow, const Texture& tileset,
+                      Vector2 textureSize) {
+    Chunk& chunk = chunks_[chunkRow * chunkColumns_ + chunkColumn];
+    chunk.vertices.clear();
+    chunk.dirty = false;
+    const int tilesetColumns = std::max(static_cast<int>(tileset.source.w) / tileSize_, 1);
+    const float size = static_cast<float>(tileSize_);
+    const int firstColumn = chunkColumn * chunkSize_;
+    const int firstRow = chunkRow * chunkSize_;
+    const int lastColumn = std::min(firstColumn + chunkSize_, columns_);
+    const int lastRow = std::min(firstRow + chunkSize_, rows_);
+    for (int row = firstRow; row < lastRow; ++row) {
+        for (int column = firstColumn; column < lastColumn; ++column) {
+            const Tile tile = tiles_[static_cast<std::size_t>(row) * columns_ + column];
+            if (tile == EMPTY_TILE) {
+                continue;
+            }
+            float u0 = 0.0f;
+            float v0 = 0.0f;
+            float u1 = 0.0f;
+            float v1 = 0.0f;
+            if (tileset.handle) {
+                const int cell = tile - 1;
+                const float sourceX = tileset.source.x + (cell % tilesetColumns) * size;
+                const float sourceY = tileset.source.y + (cell / tilesetColumns) * size;
+                u0 = sourceX / textureSize.x;
+                v0 = sourceY / textureSize.y;
+                u1 = (sourceX + size) / textureSize.x;
+                v1 = (sourceY + size) / textureSize.y;
+            }
+            const float x = column * size;
+            const float y = row * size;
+            chunk.vertices.push_back({{x, y}, {}, {u0, v0}});
+            chunk.vertices.push_back({{x + size, y}, {}, {u1, v0}});
+            chunk.vertices.push_back({{x + size, y + size}, {}, {u1, v1}});
+            chunk.vertices.push_back({{x, y + size}, {}, {u0, v1}});
+        }
+    }
+}
+
+void Tilemap::markAllDirty() {
+    for (Chunk& chunk : chunks_) {
+        chunk.dirty = true;
+    }
+}
+
+}  // namespace ast
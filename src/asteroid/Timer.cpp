@@ -1,5 +1,8 @@
 #include "asteroid/Timer.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace ast {
 
 Timer::Timer(int target_fps)
@@ -18,16 +21,23 @@ void Timer::startFrame() {
     // Calculate the frame time for the current frame
     double frame_sec =
         static_cast<double>(startFrameTime_ - previousFrameTime_) / SDL_GetPerformanceFrequency();
-#ifdef AST_TIMER_FRAME_HISTORY
-    frameSecHistory_.push(frame_sec);
-    frameSecSum_ += frame_sec;
-    if (frameSecHistory_.size() > frameSecSamples_s) {
-        frameSecSum_ -= frameSecHistory_.front();
-        frameSecHistory_.pop();
+    lastFrameSec_ = frame_sec;
+    if (historyCount_ == FRAME_HISTORY_SIZE) {
+        frameSecSum_ -= frameHistory_[historyIndex_];
+    } else {
+        ++historyCount_;
     }
-#else
+    frameHistory_[historyIndex_] = frame_sec;
+    frameSecSum_ += frame_sec;
+    historyIndex_ = (historyIndex_ + 1) % FRAME_HISTORY_SIZE;
     smoothedFrameSec_ = 0.1 * frame_sec + 0.9 * smoothedFrameSec_;
-#endif
+
+    if (hitchThreshold_ > 0.0 && frame_sec > hitchThreshold_) {
+        ++hitchCount_;
+        if (hitchCallback_) {
+            hitchCallback_(frame_sec);
+        }
+    }
 
     // Update FPS every second
     double sec_since_last_update =
@@ -40,46 +50,102 @@ void Timer::startFrame() {
 }
 
 void Timer::endFrame() {
-    uint64_t current_time = SDL_GetPerformanceCounter();
-    // Remaining time = target frame time - elapsed time - sleep error
-    double remaining_sec =
-        targetFrameSec_ -
-        static_cast<double>(current_time - startFrameTime_) / SDL_GetPerformanceFrequency() -
-        sleepError_;
-    if (remaining_sec > 0) {
-        if (remaining_sec > 0.001) {
-            // Sleep for 90% of the remaining time
-            SDL_Delay(static_cast<uint32_t>(remaining_sec * 0.9 * 1000));
-        }
-        // Busy wait for the remaining time
-        while (static_cast<double>(SDL_GetPerformanceCounter() - startFrameTime_) /
-                   SDL_GetPerformanceFrequency() <
-               targetFrameSec_) {
+    if (pacing_ == Pacing::VSync || pacing_ == Pacing::Uncapped) {
+        return;
+    }
+    const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+    auto elapsedSince = [frequency](uint64_t time) {
+        return static_cast<double>(SDL_GetPerformanceCounter() - time) / frequency;
+    };
+    double remaining_sec = targetFrameSec_ - elapsedSince(startFrameTime_);
+    if (remaining_sec <= 0) {
+        return;  // The frame overran, nothing to wait for
+    }
+
+    // Wake up early by the usual oversleep, and early enough to spin for the rest
+    const double spin_sec = pacing_ == Pacing::SleepAndSpin ? spinThreshold_ : 0.0;
+    const double sleep_sec = remaining_sec - oversleep_ - spin_sec;
+    if (sleep_sec > 0) {
+        uint64_t sleep_start = SDL_GetPerformanceCounter();
+        SDL_DelayNS(static_cast<Uint64>(sleep_sec * SDL_NS_PER_SECOND));
+        double slept_sec = elapsedSince(sleep_start);
+        pacingStats_.sleepTime += slept_sec;
+        oversleep_ = 0.9 * oversleep_ + 0.1 * std::max(slept_sec - sleep_sec, 0.0);
+    }
+    if (pacing_ == Pacing::SleepAndSpin) {
+        uint64_t spin_start = SDL_GetPerformanceCounter();
+        while (elapsedSince(startFrameTime_) < targetFrameSec_) {
             SDL_Delay(0);
         }
-        // Update sleep error
-        double actual_sleep_sec = static_cast<double>(SDL_GetPerformanceCounter() - current_time) /
-                                  SDL_GetPerformanceFrequency();
-        sleepError_ = (remaining_sec - actual_sleep_sec) * 0.5;
-    } else {
-        sleepError_ = 0.0;  // Reset sleep error if overslept
+        pacingStats_.spinTime += elapsedSince(spin_start);
     }
+
+    double error = std::abs(elapsedSince(startFrameTime_) - targetFrameSec_);
+    ++pacingStats_.frames;
+    errorSum_ += error;
+    pacingStats_.meanError = errorSum_ / pacingStats_.frames;
+    pacingStats_.maxError = std::max(pacingStats_.maxError, error);
 }
 
 double Timer::getDeltaTime() const {
 #ifdef AST_TIMER_FRAME_HISTORY
-    return frameSecSum_ / frameSecHistory_.size();
+    return historyCount_ > 0 ? frameSecSum_ / historyCount_ : targetFrameSec_;
 #else
     return smoothedFrameSec_;
 #endif
 }
 
+Timer::FrameStats Timer::getFrameStats() const {
+    FrameStats stats;
+    stats.frames = historyCount_;
+    if (historyCount_ == 0) {
+        return stats;
+    }
+    std::array<double, FRAME_HISTORY_SIZE> sorted;
+    std::copy_n(frameHistory_.begin(), historyCount_, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + historyCount_);
+    // Nearest-rank percentile
+    auto percentile = [&](double p) {
+        auto rank = static_cast<std::size_t>(std::ceil(p * historyCount_));
+        return sorted[std::clamp<std::size_t>(rank, 1, historyCount_) - 1];
+    };
+    stats.mean = frameSecSum_ / historyCount_;
+    stats.p50 = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.p99 = percentile(0.99);
+    stats.max = sorted[historyCount_ - 1];
+    return stats;
+}
+
+std::vector<std::size_t> Timer::getHistogram(std::size_t bucketCount, double bucketWidth) const {
+    std::vector<std::size_t> buckets(bucketCount);
+    if (bucketCount == 0 || bucketWidth <= 0.0) {
+        return buckets;
+    }
+    for (std::size_t i = 0; i < historyCount_; ++i) {
+        auto bucket = static_cast<std::size_t>(frameHistory_[i] / bucketWidth);
+        ++buckets[std::min(bucket, bucketCount - 1)];
+    }
+    return buckets;
+}
+
+void Timer::setHitchThreshold(double seconds, HitchCallback callback) {
+    hitchThreshold_ = seconds;
+    hitchCallback_ = std::move(callback);
+}
+
 void Timer::reset() {
     frames_ = 0;
     startFrameTime_ = SDL_GetPerformanceCounter();
     previousFrameTime_ = startFrameTime_;
     smoothedFrameSec_ = targetFrameSec_;
-    sleepError_ = 0.0;
+    lastFrameSec_ = 0.0;
+    historyCount_ = 0;
+    historyIndex_ = 0;
+    frameSecSum_ = 0.0;
+    hitchCount_ = 0;
+    oversleep_ = 0.0;
+    resetPacingStats();
     averageFps_ = 0.0;
     lastFpsUpdateTime_ = startFrameTime_;
 }
@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include "asteroid/AssetPack.hpp"
+
+#include <SDL3/SDL_iostream.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using ast::AssetPack;
+
+class AssetPackTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() / "asteroid_asset_pack_test";
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_ / "assets" / "images");
+        writeFile("assets/a.txt", "first asset");
+        writeFile("assets/images/b.bin", std::string("\0\1\2 binary", 10));
+        writeFile("assets/empty", "");
+        pack_ = directory_ / "assets.pak";
+        ASSERT_TRUE(AssetPack::write(directory_ / "assets", pack_));
+    }
+
+    void TearDown() override {
+        AssetPack::closeAll();
+        std::filesystem::remove_all(directory_);
+    }
+
+    void writeFile(const std::string& name, const std::string& contents) {
+        std::ofstream(directory_ / name, std::ios::binary) << contents;
+    }
+
+    static std::string readAll(SDL_IOStream* io) {
+        std::string contents;
+        char buffer[4];
+        std::size_t count = 0;
+        while ((count = SDL_ReadIO(io, buffer, sizeof(buffer))) > 0) {
+            contents.append(buffer, count);
+        }
+        return contents;
+    }
+
+    std::filesystem::path directory_;
+    std::filesystem::path pack_;
+};
+
+TEST_F(AssetPackTest, RoundTripsEveryFile) {
+    auto pack = AssetPack::open(pack_);
+    ASSERT_NE(pack, nullptr);
+    EXPECT_EQ(pack->getEntryCount(), 3u);
+
+    const AssetPack::IndexEntry* entry = pack->find("images/b.bin");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(pack->getName(*entry), "images/b.bin");
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(pack->getData(*entry)), entry->size),
+              std::string("\0\1\2 binary", 10));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(pack->getData(*entry)) % AssetPack::ALIGNMENT,
+              0u);
+
+    ASSERT_NE(pack->find("empty"), nullptr);
+    EXPECT_EQ(pack->find("empty")->size, 0u);
+    EXPECT_EQ(pack->find("missing"), nullptr);
+    // Opening the same file again shares the mapping
+    EXPECT_EQ(AssetPack::open(pack_), pack);
+}
+
+TEST_F(AssetPackTest, ResolvesPathsThroughThePack) {
+    auto asset = AssetPack::resolve(pack_ / "a.txt");
+    ASSERT_TRUE(asset.has_value());
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(asset->data), asset->size),
+              "first asset");
+    EXPECT_FALSE(AssetPack::resolve(pack_ / "missing.txt").has_value());
+    EXPECT_FALSE(AssetPack::resolve(directory_ / "assets" / "a.txt").has_value());
+}
+
+TEST_F(AssetPackTest, StreamsKeepThePackMapped) {
+    SDL_IOStream* io = AssetPack::openIO(pack_ / "a.txt");
+    ASSERT_NE(io, nullptr);
+    // Nothing else holds the pack, so only the stream keeps it mapped
+    AssetPack::closeAll();
+    EXPECT_EQ(SDL_GetIOSize(io), 11);
+    EXPECT_EQ(readAll(io), "first asset");
+    EXPECT_EQ(SDL_SeekIO(io, -5, SDL_IO_SEEK_END), 6);
+    EXPECT_EQ(readAll(io), "asset");
+    EXPECT_TRUE(SDL_CloseIO(io));
+}
+
+TEST_F(AssetPackTest, OpensLooseFilesFromDisk) {
+    SDL_IOStream* io = AssetPack::openIO(directory_ / "assets" / "a.txt");
+    ASSERT_NE(io, nullptr);
+    EXPECT_EQ(readAll(io), "first asset");
+    SDL_CloseIO(io);
+    EXPECT_EQ(AssetPack::openIO(pack_ / "missing.txt"), nullptr);
+}
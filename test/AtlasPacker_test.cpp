@@ -0,0 +1,48 @@
+#include "gtest/gtest.h"
+#include "asteroid/AtlasPacker.hpp"
+
+#include <vector>
+
+namespace {
+
+struct PlacedRect {
+    int x, y, w, h;
+};
+
+bool overlaps(const PlacedRect& a, const PlacedRect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+}  // namespace
+
+TEST(AtlasPacker, PlacesRectanglesWithoutOverlap) {
+    ast::AtlasPacker packer(256, 256);
+    std::vector<PlacedRect> placed;
+    for (int i = 0; i < 40; ++i) {
+        int w = 8 + (i * 7) % 40;
+        int h = 8 + (i * 13) % 30;
+        auto placement = packer.pack(w, h);
+        ASSERT_TRUE(placement.has_value());
+        PlacedRect rect{placement->x, placement->y, w, h};
+        EXPECT_GE(rect.x, 0);
+        EXPECT_GE(rect.y, 0);
+        EXPECT_LE(rect.x + rect.w, 256);
+        EXPECT_LE(rect.y + rect.h, 256);
+        for (const auto& other : placed) {
+            EXPECT_FALSE(overlaps(rect, other));
+        }
+        placed.push_back(rect);
+    }
+}
+
+TEST(AtlasPacker, RejectsWhenFull) {
+    ast::AtlasPacker packer(64, 64);
+    EXPECT_FALSE(packer.pack(65, 1).has_value());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(packer.pack(32, 32).has_value());
+    }
+    EXPECT_FLOAT_EQ(packer.getOccupancy(), 1.0f);
+    EXPECT_FALSE(packer.pack(1, 1).has_value());
+    packer.reset();
+    EXPECT_TRUE(packer.pack(64, 64).has_value());
+}
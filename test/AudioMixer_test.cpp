@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+#include "asteroid/AudioMixer.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+std::shared_ptr<const ast::AudioSample> makeSample(std::size_t frameCount, float value) {
+    auto sample = std::make_shared<ast::AudioSample>();
+    sample->channels = 2;
+    sample->frameCount = frameCount;
+    sample->data.assign(frameCount * 2, value);
+    return sample;
+}
+
+}  // namespace
+
+TEST(AudioMixer, OverlapsVoicesOfTheSameSample) {
+    ast::AudioMixer mixer(2, 4);
+    auto sample = makeSample(64, 0.25f);
+    EXPECT_TRUE(mixer.play(1, sample, {}));
+    EXPECT_TRUE(mixer.play(2, sample, {}));
+    EXPECT_EQ(mixer.getActiveVoiceCount(), 2u);
+
+    std::vector<float> out(40 * 2);
+    mixer.mix(out.data(), 32);
+    for (std::size_t i = 0; i < 32 * 2; ++i) {
+        EXPECT_FLOAT_EQ(out[i], 0.5f);
+    }
+    // Both voices finish after the remaining 32 frames
+    mixer.mix(out.data(), 40);
+    EXPECT_FLOAT_EQ(out[31 * 2], 0.5f);
+    EXPECT_FLOAT_EQ(out[32 * 2], 0.0f);
+    EXPECT_FALSE(mixer.isPlaying(sample.get()));
+}
+
+TEST(AudioMixer, StealsLowestPriorityVoice) {
+    ast::AudioMixer mixer(2, 2);
+    auto sample = makeSample(64, 0.1f);
+    EXPECT_TRUE(mixer.play(1, sample, {.priority = 1}));
+    EXPECT_TRUE(mixer.play(2, sample, {.priority = 0}));
+    EXPECT_TRUE(mixer.play(3, sample, {.priority = 0}));
+    EXPECT_TRUE(mixer.isPlaying(1));
+    EXPECT_FALSE(mixer.isPlaying(2));
+    EXPECT_TRUE(mixer.isPlaying(3));
+    EXPECT_FALSE(mixer.play(4, sample, {.priority = -1}));
+    EXPECT_EQ(mixer.getStats().stolenVoices, 1u);
+    EXPECT_EQ(mixer.getStats().rejectedVoices, 1u);
+}
+
+TEST(AudioMixer, LoopsAndPitch) {
+    ast::AudioMixer mixer(2, 2);
+    auto sample = makeSample(16, 1.0f);
+    EXPECT_TRUE(mixer.play(1, sample, {.pitch = 2.0f, .loops = 2}));
+    std::vector<float> out(32 * 2);
+    // Twice the rate: two passes over 16 frames take 16 output frames
+    mixer.mix(out.data(), 32);
+    EXPECT_FLOAT_EQ(out[15 * 2], 1.0f);
+    EXPECT_FLOAT_EQ(out[16 * 2], 0.0f);
+    EXPECT_FALSE(mixer.isPlaying(1));
+
+    EXPECT_TRUE(mixer.play(2, sample, {.loops = 0}));
+    mixer.mix(out.data(), 32);
+    EXPECT_FLOAT_EQ(out[31 * 2 + 1], 1.0f);
+    mixer.stop(2);
+    EXPECT_EQ(mixer.getActiveVoiceCount(), 0u);
+}
+
+TEST(AudioMixer, MixesInt16Samples) {
+    ast::AudioMixer mixer(2, 2);
+    auto sample = std::make_shared<ast::AudioSample>();
+    sample->channels = 2;
+    sample->frameCount = 20;
+    sample->data16.assign(40, 16384);
+    EXPECT_EQ(sample->getByteSize(), 80u);
+    EXPECT_TRUE(mixer.play(1, sample, {.gain = 0.5f}));
+    std::vector<float> out(20 * 2);
+    mixer.mix(out.data(), 20);
+    for (float value : out) {
+        EXPECT_FLOAT_EQ(value, 0.25f);
+    }
+}
+
+TEST(AudioMixer, PansStereoVoices) {
+    ast::AudioMixer mixer(2, 2);
+    auto sample = makeSample(16, 1.0f);
+    EXPECT_TRUE(mixer.play(1, sample, {.gain = 0.5f, .pan = -1.0f}));
+    std::vector<float> out(8 * 2);
+    mixer.mix(out.data(), 8);
+    EXPECT_FLOAT_EQ(out[0], 0.5f);
+    EXPECT_FLOAT_EQ(out[1], 0.0f);
+    // Half right keeps the right channel and halves the left
+    mixer.setPan(1, 0.5f);
+    mixer.mix(out.data(), 8);
+    EXPECT_FLOAT_EQ(out[0], 0.25f);
+    EXPECT_FLOAT_EQ(out[1], 0.5f);
+}
+
+TEST(AudioMixer, MaxVoicesOnlyChangesTheLimit) {
+    ast::AudioMixer mixer(2, 4);
+    auto sample = makeSample(64, 0.1f);
+    for (ast::VoiceId id = 1; id <= 4; ++id) {
+        EXPECT_TRUE(mixer.play(id, sample, {}));
+    }
+    mixer.clearEndedVoices();
+
+    // Voices beyond the new limit are stopped and reported as ended
+    mixer.setMaxVoices(2);
+    EXPECT_EQ(mixer.getActiveVoiceCount(), 2u);
+    EXPECT_EQ(mixer.getEndedVoices().size(), 2u);
+    EXPECT_FALSE(mixer.play(5, sample, {.priority = -1}));
+
+    mixer.setMaxVoices(ast::AudioMixer::MAX_VOICES + 1);
+    EXPECT_EQ(mixer.getStats().maxVoices, ast::AudioMixer::MAX_VOICES);
+    EXPECT_TRUE(mixer.play(6, sample, {.priority = -1}));
+    EXPECT_EQ(mixer.getActiveVoiceCount(), 3u);
+}
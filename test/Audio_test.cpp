@@ -0,0 +1,27 @@
+#include "gtest/gtest.h"
+#include "asteroid/Audio.hpp"
+#include "TestWav.hpp"
+
+#include <filesystem>
+
+TEST(Audio, CountsOneCacheLookupPerPlay) {
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto path = directory / "asteroid_audio_test.wav";
+    ast::test::writeToneWav(path, 48000);
+    ast::Audio& audio = ast::Audio::getInstance();
+    ASSERT_TRUE(audio.initOffline(2, 48000));
+    audio.setAssetsDirectory(directory);
+    const ast::Audio::Stats before = audio.getStats();
+
+    // Playing an unloaded sound loads it first
+    EXPECT_NE(audio.playSound(path.filename().string()), ast::NULL_VOICE_ID);
+    EXPECT_EQ(audio.getStats().misses, before.misses + 1);
+    EXPECT_EQ(audio.getStats().hits, before.hits);
+
+    EXPECT_NE(audio.playSound(path.filename().string()), ast::NULL_VOICE_ID);
+    EXPECT_EQ(audio.getStats().misses, before.misses + 1);
+    EXPECT_EQ(audio.getStats().hits, before.hits + 1);
+
+    audio.shutdown();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,278 @@
+#include "gtest/gtest.h"
+#include "asteroid/Cache.hpp"
+#include "TestRenderer.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using ast::Cache;
+using ast::TextureHandle;
+
+class CacheTest : public ast::test::RendererTest {
+protected:
+    static constexpr int IMAGE_SIZE = 16;
+    static constexpr std::size_t IMAGE_BYTES = IMAGE_SIZE * IMAGE_SIZE * 4;
+
+    void SetUp() override {
+        ASSERT_NO_FATAL_FAILURE(RendererTest::SetUp());
+
+        directory_ = std::filesystem::temp_directory_path() / "asteroid_cache_test";
+        std::filesystem::create_directories(directory_);
+        SDL_Surface* image = SDL_CreateSurface(IMAGE_SIZE, IMAGE_SIZE, SDL_PIXELFORMAT_RGBA32);
+        ASSERT_NE(image, nullptr);
+        for (const char* name : {"a.bmp", "b.bmp", "c.bmp"}) {
+            ASSERT_TRUE(SDL_SaveBMP(image, (directory_ / name).string().c_str()));
+        }
+        SDL_DestroySurface(image);
+
+        Cache::setAssetsDirectory(directory_);
+        Cache::init(renderer_);
+        baseBytes_ = Cache::getStats().residentBytes;
+    }
+
+    void TearDown() override {
+        Cache::shutdown();
+        Cache::setMemoryBudget(0);
+        Cache::setAtlasOptions({});
+        Cache::setAssetsDirectory({});
+        std::filesystem::remove_all(directory_);
+        RendererTest::TearDown();
+    }
+
+    static void advance(int frames) {
+        for (int i = 0; i < frames; ++i) {
+            Cache::update(0.0);
+        }
+    }
+
+    // Run updates until the decode workers have delivered every pending texture
+    static bool waitForPending() {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (Cache::getPendingCount() > 0) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            Cache::update(1.0);
+        }
+        return true;
+    }
+
+    std::filesystem::path directory_;
+    std::size_t baseBytes_ = 0;
+};
+
+TEST_F(CacheTest, GetTextureReferenceSurvivesNewNames) {
+    const ast::Texture& texture = Cache::getTexture("a.bmp");
+    for (int i = 0; i < 100; ++i) {
+        Cache::getTextureId("missing_" + std::to_string(i) + ".bmp");
+    }
+    EXPECT_EQ(&texture, &Cache::getTexture("a.bmp"));
+}
+
+TEST_F(CacheTest, EvictsLeastRecentlyUsedOverBudget) {
+    Cache::getTexture("a.bmp");
+    advance(2);
+    Cache::getTexture("b.bmp");
+    Cache::getTexture("c.bmp");
+    EXPECT_EQ(Cache::getStats().residentBytes, baseBytes_ + 3 * IMAGE_BYTES);
+
+    Cache::setMemoryBudget(baseBytes_ + 2 * IMAGE_BYTES);
+    const Cache::Stats before = Cache::getStats();
+    advance(1);
+    Cache::Stats stats = Cache::getStats();
+    EXPECT_EQ(stats.evictions - before.evictions, 1u);
+    EXPECT_EQ(stats.textureCount, 2u);
+    EXPECT_EQ(stats.residentBytes, baseBytes_ + 2 * IMAGE_BYTES);
+
+    // b and c are still resident, a has to be loaded again
+    Cache::getTexture("b.bmp");
+    Cache::getTexture("c.bmp");
+    EXPECT_EQ(Cache::getStats().misses, stats.misses);
+    Cache::getTexture("a.bmp");
+    EXPECT_EQ(Cache::getStats().misses, stats.misses + 1);
+}
+
+TEST_F(CacheTest, HandlesKeepTexturesResident) {
+    Cache::setMemoryBudget(1);
+    TextureHandle handle = Cache::acquireTexture("a.bmp");
+    ASSERT_TRUE(handle);
+    advance(3);
+    EXPECT_TRUE(handle);
+    EXPECT_EQ(Cache::getStats().textureCount, 1u);
+
+    TextureHandle copy = handle;
+    handle = {};
+    advance(3);
+    EXPECT_TRUE(copy);
+
+    // Textures stay for one more frame after the last handle is released
+    copy = {};
+    advance(1);
+    EXPECT_EQ(Cache::getStats().textureCount, 1u);
+    advance(1);
+    EXPECT_EQ(Cache::getStats().textureCount, 0u);
+    EXPECT_EQ(Cache::getStats().residentBytes, baseBytes_);
+}
+
+TEST_F(CacheTest, EvictsAtlasPagesWhole) {
+    Cache::setAtlasOptions({.enabled = true, .pageSize = 64});
+    const ast::Rect source = Cache::getTexture("a.bmp").source;
+    TextureHandle handle = Cache::acquireTexture("b.bmp");
+    EXPECT_EQ(Cache::getStats().atlasPageCount, 1u);
+    EXPECT_EQ(Cache::getStats().textureCount, 2u);
+
+    // a is idle, but evicting it alone would not free its page
+    Cache::setMemoryBudget(1);
+    const Cache::Stats before = Cache::getStats();
+    advance(3);
+    EXPECT_EQ(Cache::getStats().evictions, before.evictions);
+    EXPECT_EQ(Cache::getStats().textureCount, 2u);
+
+    handle = {};
+    advance(2);
+    Cache::Stats stats = Cache::getStats();
+    EXPECT_EQ(stats.evictions - before.evictions, 2u);
+    EXPECT_EQ(stats.atlasPageCount, 0u);
+    EXPECT_EQ(stats.residentBytes, baseBytes_);
+
+    // A reload goes back to the slot the image had
+    EXPECT_EQ(Cache::getTexture("a.bmp").source, source);
+    EXPECT_EQ(Cache::getStats().atlasPageCount, 1u);
+}
+
+TEST_F(CacheTest, InitReplacesDummyTexturesOfThePreviousRenderer) {
+    SDL_Surface* surface = SDL_CreateSurface(16, 16, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer* other = SDL_CreateSoftwareRenderer(surface);
+    ASSERT_NE(other, nullptr);
+
+    Cache::init(other);
+    EXPECT_EQ(SDL_GetRendererFromTexture(Cache::MISSING_TEXTURE.handle), other);
+    EXPECT_EQ(Cache::getStats().dummyTextureCount, 1u);
+
+    Cache::init(renderer_);
+    EXPECT_EQ(SDL_GetRendererFromTexture(Cache::MISSING_TEXTURE.handle), renderer_);
+    EXPECT_EQ(Cache::getStats().residentBytes, baseBytes_);
+    SDL_DestroyRenderer(other);
+    SDL_DestroySurface(surface);
+}
+
+TEST_F(CacheTest, RequestTextureReturnsPlaceholderUntilUploaded) {
+    const ast::Texture placeholder = Cache::getDummyTexture(ast::Color::GREEN);
+    const Cache::Stats before = Cache::getStats();
+    EXPECT_EQ(Cache::requestTexture("a.bmp", placeholder).handle, placeholder.handle);
+    EXPECT_EQ(Cache::getPendingCount(), 1u);
+    // Asking again does not queue a second decode
+    EXPECT_EQ(Cache::requestTexture("a.bmp", placeholder).handle, placeholder.handle);
+    EXPECT_EQ(Cache::getStats().misses, before.misses + 1);
+
+    ASSERT_TRUE(waitForPending());
+    const ast::Texture& texture = Cache::requestTexture("a.bmp", placeholder);
+    EXPECT_NE(texture.handle, placeholder.handle);
+    EXPECT_EQ(texture.size, ast::Vector2(IMAGE_SIZE * 1.0f, IMAGE_SIZE * 1.0f));
+    EXPECT_EQ(Cache::getStats().textureCount, 1u);
+}
+
+TEST_F(CacheTest, UploadsAtLeastOneImagePerUpdate) {
+    for (const char* name : {"a.bmp", "b.bmp", "c.bmp"}) {
+        Cache::requestTexture(name);
+    }
+    // Without any time budget each update uploads exactly one decoded image
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    std::size_t textureCount = 0;
+    while (Cache::getPendingCount() > 0) {
+        ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        Cache::update(0.0);
+        const std::size_t count = Cache::getStats().textureCount;
+        EXPECT_LE(count, textureCount + 1);
+        textureCount = count;
+    }
+    EXPECT_EQ(textureCount, 3u);
+}
+
+TEST_F(CacheTest, PreloadCallbackFiresOnceWhenGroupIsResident) {
+    int calls = 0;
+    Cache::preload({"a.bmp", "b.bmp", "a.bmp"}, [&calls] { ++calls; });
+    EXPECT_EQ(calls, 0);
+    ASSERT_TRUE(waitForPending());
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(Cache::getStats().textureCount, 2u);
+    advance(3);
+    EXPECT_EQ(calls, 1);
+
+    // A group that is already resident completes on the next update
+    int residentCalls = 0;
+    const Cache::Stats before = Cache::getStats();
+    Cache::preload({"a.bmp", "b.bmp"}, [&residentCalls] { ++residentCalls; });
+    EXPECT_EQ(residentCalls, 0);
+    EXPECT_EQ(Cache::getPendingCount(), 0u);
+    advance(1);
+    EXPECT_EQ(residentCalls, 1);
+    advance(3);
+    EXPECT_EQ(residentCalls, 1);
+    EXPECT_EQ(Cache::getStats().misses, before.misses);
+}
+
+TEST_F(CacheTest, FailedDecodeKeepsReturningPlaceholder) {
+    std::ofstream(directory_ / "broken.bmp") << "not an image";
+    const ast::Texture placeholder = Cache::getDummyTexture(ast::Color::GREEN);
+    int calls = 0;
+    Cache::preload({"broken.bmp"}, [&calls] { ++calls; });
+    ASSERT_TRUE(waitForPending());
+    // Failed textures complete their preload group
+    EXPECT_EQ(calls, 1);
+
+    const Cache::Stats before = Cache::getStats();
+    EXPECT_EQ(Cache::requestTexture("broken.bmp", placeholder).handle, placeholder.handle);
+    EXPECT_EQ(Cache::getTexture("broken.bmp").handle, Cache::MISSING_TEXTURE.handle);
+    // Marked as failed, so neither call tries to decode it again
+    EXPECT_EQ(Cache::getPendingCount(), 0u);
+    EXPECT_EQ(Cache::getStats().misses, before.misses);
+    EXPECT_EQ(Cache::getStats().textureCount, 0u);
+}
+
+TEST_F(CacheTest, ClearDropsDecodesInFlight) {
+    int calls = 0;
+    Cache::preload({"a.bmp", "b.bmp", "c.bmp"}, [&calls] { ++calls; });
+    Cache::clear();
+    EXPECT_EQ(Cache::getPendingCount(), 0u);
+
+    // Results of the cancelled requests still arrive, and are discarded
+    for (int i = 0; i < 50; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        Cache::update(1.0);
+    }
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(Cache::getStats().textureCount, 0u);
+    EXPECT_EQ(Cache::getStats().residentBytes, baseBytes_);
+}
+
+TEST_F(CacheTest, ShutdownDropsDecodesInFlight) {
+    SDL_Surface* image = SDL_CreateSurface(IMAGE_SIZE, IMAGE_SIZE, SDL_PIXELFORMAT_RGBA32);
+    ASSERT_NE(image, nullptr);
+    std::vector<std::string> names;
+    for (int i = 0; i < 32; ++i) {
+        names.push_back("image_" + std::to_string(i) + ".bmp");
+        ASSERT_TRUE(SDL_SaveBMP(image, (directory_ / names.back()).string().c_str()));
+    }
+    SDL_DestroySurface(image);
+
+    int calls = 0;
+    Cache::preload(names, [&calls] { ++calls; });
+    Cache::shutdown();
+    EXPECT_EQ(Cache::getPendingCount(), 0u);
+    EXPECT_EQ(Cache::getStats().residentBytes, 0u);
+
+    // Nothing decoded before the shutdown reaches the next renderer
+    Cache::init(renderer_);
+    advance(3);
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(Cache::getStats().textureCount, 0u);
+    EXPECT_EQ(Cache::getStats().residentBytes, baseBytes_);
+}
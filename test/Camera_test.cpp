@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+#include "asteroid/Camera.hpp"
+
+#include <random>
+
+using ast::Camera;
+using ast::Rect;
+using ast::Vector2;
+
+TEST(Camera, MapsWorldToViewport) {
+    Camera camera({100.0f, 50.0f}, {10.0f, 20.0f, 200.0f, 100.0f}, 2.0f);
+    EXPECT_EQ(camera.getVisibleArea(), Rect(50.0f, 25.0f, 100.0f, 50.0f));
+    EXPECT_EQ(camera.worldToScreen(Vector2(100.0f, 50.0f)), Vector2(110.0f, 70.0f));
+    EXPECT_EQ(camera.worldToScreen(Vector2(50.0f, 25.0f)), Vector2(10.0f, 20.0f));
+    EXPECT_EQ(camera.screenToWorld(Vector2(210.0f, 120.0f)), Vector2(150.0f, 75.0f));
+    EXPECT_EQ(camera.worldToScreen(Rect(100.0f, 50.0f, 4.0f, 3.0f)),
+              Rect(110.0f, 70.0f, 8.0f, 6.0f));
+}
+
+TEST(Camera, CullsRectsOutsideTheArea) {
+    const Rect area{0.0f, 0.0f, 100.0f, 100.0f};
+    const std::vector<Rect> bounds{
+        {10.0f, 10.0f, 5.0f, 5.0f},        // Inside
+        {-10.0f, -10.0f, 15.0f, 15.0f},    // Overlapping the corner
+        {100.0f, 0.0f, 10.0f, 10.0f},      // Touching the right edge
+        {-20.0f, 50.0f, 10.0f, 10.0f},     // Left of the area
+        {50.0f, 150.0f, 10.0f, 0.0f},      // Below the area
+        {-50.0f, -50.0f, 300.0f, 300.0f},  // Containing the area
+    };
+    std::vector<std::uint32_t> visible;
+    EXPECT_EQ(ast::cullRects(bounds, area, visible), 3u);
+    EXPECT_EQ(visible, (std::vector<std::uint32_t>{0, 1, 5}));
+}
+
+TEST(Camera, VectorizedCullingMatchesScalarTest) {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(0.0f, 80.0f);
+    const Rect area{-100.0f, -60.0f, 200.0f, 120.0f};
+    // Sizes around the SIMD width exercise the scalar tail
+    for (std::size_t count : {0u, 1u, 3u, 4u, 5u, 1000u, 1003u}) {
+        std::vector<Rect> bounds;
+        std::vector<std::uint32_t> expected;
+        for (std::size_t i = 0; i < count; ++i) {
+            const Rect rect{position(random), position(random), size(random), size(random)};
+            if (rect.x < area.x + area.w && rect.x + rect.w > area.x &&
+                rect.y < area.y + area.h && rect.y + rect.h > area.y) {
+                expected.push_back(static_cast<std::uint32_t>(i));
+            }
+            bounds.push_back(rect);
+        }
+        std::vector<std::uint32_t> visible;
+        EXPECT_EQ(ast::cullRects(bounds, area, visible), expected.size());
+        EXPECT_EQ(visible, expected);
+    }
+}
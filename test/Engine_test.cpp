@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "asteroid/Cache.hpp"
+#include "asteroid/Engine.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Extracts its number of update steps as the position of a sprite and records the
+// position it finds in the snapshot when rendered
+class CountingScene : public ast::Scene {
+public:
+    using Scene::Scene;
+
+    void update(float dt) override { ++steps_; }
+
+    void extract(ast::RenderSnapshot& snapshot) override {
+        snapshot.sprites.push_back({.current = ast::Rect{static_cast<float>(steps_), 0, 1, 1}});
+    }
+
+    void render() override {
+        const auto& sprites = engine_->getRenderSnapshot().sprites;
+        rendered.push_back(sprites.empty() ? -1 : static_cast<int>(sprites.front().current.x));
+    }
+
+    std::vector<int> rendered;
+
+private:
+    int steps_ = 0;
+};
+
+}  // namespace
+
+TEST(Engine, RunsHeadlessFramesAtAFixedStep) {
+    ast::Engine engine("Test", 320, 240, "assets", ast::Engine::Mode::Headless);
+    EXPECT_EQ(engine.runFrames(10), 10);
+    EXPECT_EQ(engine.getRenderSnapshot().step, 10u);
+    EXPECT_FLOAT_EQ(engine.getInterpolationAlpha(), 0.0f);
+}
+
+TEST(Engine, PipelinedFramesPublishEveryStep) {
+    ast::Engine engine("Test", 320, 240, "assets", ast::Engine::Mode::Headless);
+    engine.setPipelined(true);
+    EXPECT_EQ(engine.runFrames(10), 10);
+    // runFrames() returns with the last simulated snapshot published; what render() sees
+    // is covered by PipelinedScenesRenderOneFrameLate
+    EXPECT_EQ(engine.getRenderSnapshot().step, 10u);
+    EXPECT_EQ(engine.runFrames(1), 1);
+    EXPECT_EQ(engine.getRenderSnapshot().step, 11u);
+}
+
+TEST(Engine, StopsRunningFramesOnQuit) {
+    ast::Engine engine("Test", 320, 240, "assets", ast::Engine::Mode::Headless);
+    engine.quit();
+    EXPECT_EQ(engine.runFrames(10), 0);
+}
+
+TEST(Engine, ScenesFillTheSnapshot) {
+    ast::Engine engine("Test", 320, 240, "assets", ast::Engine::Mode::Headless);
+    engine.setScene(std::make_unique<CountingScene>(&engine));
+    EXPECT_EQ(engine.getScene(), nullptr);
+    EXPECT_EQ(engine.runFrames(3), 3);
+    ASSERT_NE(engine.getScene(), nullptr);
+    ASSERT_EQ(engine.getRenderSnapshot().sprites.size(), 1u);
+    EXPECT_FLOAT_EQ(engine.getRenderSnapshot().sprites.front().current.x, 3.0f);
+}
+
+TEST(Engine, PipelinedScenesRenderOneFrameLate) {
+    for (bool pipelined : {false, true}) {
+        ast::Engine engine("Test", 320, 240, "assets", ast::Engine::Mode::HeadlessSoftware);
+        auto scene = std::make_unique<CountingScene>(&engine);
+        CountingScene* counting = scene.get();
+        engine.setScene(std::move(scene));
+        engine.setPipelined(pipelined);
+        EXPECT_EQ(engine.runFrames(4), 4);
+        // Each frame draws the snapshot taken by the previous one while simulating the next
+        const std::vector<int> expected =
+            pipelined ? std::vector<int>{-1, 1, 2, 3} : std::vector<int>{1, 2, 3, 4};
+        EXPECT_EQ(counting->rendered, expected);
+    }
+}
+
+TEST(Engine, HeadlessModeCreatesNoTextures) {
+    ast::Engine engine("Test", 320, 240, "assets", ast::Engine::Mode::Headless);
+    EXPECT_EQ(ast::Cache::MISSING_TEXTURE.handle, nullptr);
+    EXPECT_EQ(ast::Cache::getStats().dummyTextureCount, 0u);
+}
@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+#include "asteroid/Font.hpp"
+#include "asteroid/SpriteBatch.hpp"
+#include "TestRenderer.hpp"
+
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace {
+
+// The tree ships no font, so use the one named by ASTEROID_TEST_FONT or a common system font
+std::filesystem::path findTestFont() {
+    if (const char* path = std::getenv("ASTEROID_TEST_FONT")) {
+        return path;
+    }
+    const char* candidates[] = {
+        "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+        "/usr/share/fonts/TTF/DejaVuSans.ttf",
+        "/usr/share/fonts/dejavu/DejaVuSans.ttf",
+        "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+        "/System/Library/Fonts/Supplemental/Arial.ttf",
+        "/Library/Fonts/Arial.ttf",
+        "C:/Windows/Fonts/arial.ttf",
+    };
+    for (const char* candidate : candidates) {
+        if (std::filesystem::exists(candidate)) {
+            return candidate;
+        }
+    }
+    return {};
+}
+
+}  // namespace
+
+class FontTest : public ast::test::RendererTest {
+protected:
+    void SetUp() override {
+        fontPath_ = findTestFont();
+        if (fontPath_.empty()) {
+            GTEST_SKIP() << "No font found; set ASTEROID_TEST_FONT to a TrueType file";
+        }
+        ASSERT_TRUE(TTF_Init());
+        ASSERT_NO_FATAL_FAILURE(RendererTest::SetUp());
+        font_ = std::make_unique<ast::Font>(renderer_, fontPath_, 16.0f);
+        ASSERT_TRUE(font_->isLoaded());
+    }
+
+    void TearDown() override {
+        if (fontPath_.empty()) {
+            return;
+        }
+        font_.reset();
+        RendererTest::TearDown();
+        TTF_Quit();
+    }
+
+    std::filesystem::path fontPath_;
+    std::unique_ptr<ast::Font> font_;
+};
+
+TEST_F(FontTest, StepsThroughUtf8Codepoints) {
+    ast::Font::TextLayout layout;
+    // Two bytes for the e with an acute accent
+    font_->layout("a\xC3\xA9", layout);
+    EXPECT_EQ(font_->getGlyphCount(), 2u);
+    EXPECT_EQ(layout.quads.size(), 2u);
+    EXPECT_LT(layout.quads[0].destination.x, layout.quads[1].destination.x);
+}
+
+TEST_F(FontTest, BreaksLinesAtNewlines) {
+    ast::Font::TextLayout layout;
+    font_->layout("ab\nab", layout);
+    ASSERT_EQ(layout.quads.size(), 4u);
+    EXPECT_FLOAT_EQ(layout.size.y, 2.0f * font_->getLineHeight());
+    EXPECT_FLOAT_EQ(layout.size.x, font_->measure("ab").x);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_FLOAT_EQ(layout.quads[i].destination.x, layout.quads[i + 2].destination.x);
+        EXPECT_FLOAT_EQ(layout.quads[i + 2].destination.y,
+                        layout.quads[i].destination.y + font_->getLineHeight());
+    }
+}
+
+TEST_F(FontTest, AppliesKerningBetweenGlyphs) {
+    TTF_Font* reference = TTF_OpenFont(fontPath_.string().c_str(), 16.0f);
+    ASSERT_NE(reference, nullptr);
+    int kerning = 0;
+    if (!TTF_GetGlyphKerning(reference, 'A', 'V', &kerning)) {
+        kerning = 0;
+    }
+    TTF_CloseFont(reference);
+
+    const float expected = font_->measure("A").x + font_->measure("V").x + kerning;
+    EXPECT_FLOAT_EQ(font_->measure("AV").x, expected);
+    // The second lookup comes from the kerning cache
+    EXPECT_FLOAT_EQ(font_->measure("AV").x, expected);
+}
+
+TEST_F(FontTest, CachesLayoutsByString) {
+    const ast::Font::TextLayout& score = font_->getLayout("Score");
+    const ast::Font::TextLayout& lives = font_->getLayout("Lives");
+    EXPECT_EQ(&font_->getLayout("Score"), &score);
+    EXPECT_NE(&score, &lives);
+    EXPECT_EQ(score.quads.size(), 5u);
+    EXPECT_EQ(lives.quads.size(), 5u);
+
+    // Filling the cache clears it, after which layouts are built again
+    for (std::size_t i = 0; i < ast::Font::MAX_CACHED_LAYOUTS; ++i) {
+        font_->getLayout(std::to_string(i));
+    }
+    EXPECT_EQ(font_->getLayout("Score").quads.size(), 5u);
+}
+
+TEST_F(FontTest, BatchesLabelsIntoOneDrawCallPerPage) {
+    ast::SpriteBatch batch(renderer_);
+    for (int i = 0; i < 20; ++i) {
+        font_->draw(batch, "Label " + std::to_string(i), {0.0f, i * 10.0f});
+    }
+    ASSERT_EQ(font_->getPageCount(), 1u);
+    batch.flush();
+    EXPECT_GT(batch.getStats().sprites, 20u);
+    EXPECT_EQ(batch.getStats().drawCalls, font_->getPageCount());
+}
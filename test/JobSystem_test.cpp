@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "asteroid/JobSystem.hpp"
+
+#include <atomic>
+#include <vector>
+
+TEST(JobSystem, RunsEveryJob) {
+    ast::JobSystem jobs(3);
+    std::atomic<int> sum{0};
+    ast::JobCounter counter;
+    for (int i = 1; i <= 1000; ++i) {
+        jobs.submit([&sum, i] { sum += i; }, &counter);
+    }
+    jobs.wait(counter);
+    EXPECT_TRUE(counter.isDone());
+    EXPECT_EQ(sum.load(), 500500);
+}
+
+TEST(JobSystem, WaitingThreadRunsJobsWithoutWorkers) {
+    ast::JobSystem jobs(0);
+    int count = 0;
+    ast::JobCounter counter;
+    for (int i = 0; i < 10; ++i) {
+        jobs.submit([&count] { ++count; }, &counter);
+    }
+    jobs.wait(counter);
+    EXPECT_EQ(count, 10);
+}
+
+TEST(JobSystem, RunsDependentJobsAfterTheirDependencies) {
+    ast::JobSystem jobs(2);
+    std::atomic<int> first{0};
+    std::atomic<bool> ordered{true};
+    ast::JobCounter stage1;
+    ast::JobCounter stage2;
+    for (int i = 0; i < 64; ++i) {
+        jobs.submit([&first] { ++first; }, &stage1);
+    }
+    for (int i = 0; i < 8; ++i) {
+        jobs.submitAfter(stage1, [&first, &ordered] { ordered = ordered && first == 64; }, &stage2);
+    }
+    jobs.wait(stage2);
+    EXPECT_TRUE(stage1.isDone());
+    EXPECT_TRUE(ordered.load());
+}
+
+TEST(JobSystem, NestedJobsAndParallelFor) {
+    ast::JobSystem jobs(2);
+    std::vector<int> values(10000, 1);
+    std::atomic<long> total{0};
+    ast::JobCounter counter;
+    jobs.submit(
+        [&] {
+            // Waiting inside a job helps instead of blocking the worker
+            jobs.parallelFor(values.size(), 256, [&](std::size_t begin, std::size_t end) {
+                long sum = 0;
+                for (std::size_t i = begin; i < end; ++i) {
+                    sum += values[i];
+                }
+                total += sum;
+            });
+        },
+        &counter);
+    jobs.wait(counter);
+    EXPECT_EQ(total.load(), 10000);
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "asteroid/Particles.hpp"
+
+using ast::ParticlePool;
+using ast::ParticleSpawn;
+
+TEST(ParticlePool, IntegratesEveryParticle) {
+    ParticlePool pool(7);
+    for (int i = 0; i < 7; ++i) {
+        ASSERT_TRUE(pool.spawn({.position = {static_cast<float>(i), 0.0f},
+                                .velocity = {10.0f, static_cast<float>(i)},
+                                .lifetime = 10.0f}));
+    }
+    EXPECT_FALSE(pool.spawn({}));
+    EXPECT_EQ(pool.update(0.5f, {0.0f, 2.0f}), 0u);
+    for (int i = 0; i < 7; ++i) {
+        EXPECT_FLOAT_EQ(pool.getVelocityY()[i], i + 1.0f);
+        EXPECT_FLOAT_EQ(pool.getX()[i], i + 5.0f);
+        EXPECT_FLOAT_EQ(pool.getY()[i], (i + 1.0f) * 0.5f);
+        EXPECT_FLOAT_EQ(pool.getAge()[i], 0.5f);
+    }
+}
+
+TEST(ParticlePool, CompactsDeadParticles) {
+    ParticlePool pool(100);
+    for (int i = 0; i < 100; ++i) {
+        // Every third particle dies on the first update
+        pool.spawn({.position = {static_cast<float>(i), 0.0f},
+                    .lifetime = i % 3 == 0 ? 0.05f : 1.0f});
+    }
+    EXPECT_EQ(pool.update(0.1f), 34u);
+    ASSERT_EQ(pool.size(), 66u);
+    std::vector<float> survivors(pool.getX(), pool.getX() + pool.size());
+    std::sort(survivors.begin(), survivors.end());
+    for (std::size_t i = 0; i < survivors.size(); ++i) {
+        EXPECT_NE(static_cast<int>(survivors[i]) % 3, 0);
+    }
+    EXPECT_EQ(pool.update(1.0f), 66u);
+    EXPECT_TRUE(pool.empty());
+}
+
+TEST(ParticlePool, ClearedSlotsDoNotDie) {
+    ParticlePool pool(8);
+    pool.spawn({.lifetime = 0.01f});
+    pool.clear();
+    pool.spawn({.lifetime = 1.0f});
+    EXPECT_EQ(pool.update(0.1f), 0u);
+    EXPECT_EQ(pool.size(), 1u);
+}
+
+TEST(ParticleSystem, EmitsAtTheEmitterRate) {
+    ast::Registry registry;
+    auto& system = registry.attach<ast::ParticleSystem>(registry, 64);
+    ast::Entity entity = registry.createEntity();
+    auto& emitter = registry.emplace<ast::ParticleEmitter>(entity, ast::Vector2{}, 25.0f);
+    emitter.minLifetime = emitter.maxLifetime = 100.0f;
+    // Components reach systems after the update they were added in
+    registry.update(0.0f);
+
+    // 25 per second over 0.1 s steps is 2.5 per step, the fractions carrying over
+    registry.update(0.1f);
+    registry.update(0.1f);
+    EXPECT_EQ(system.getStats().alive, 5u);
+
+    emitter.emitting = false;
+    emitter.burst = 100;
+    registry.update(0.1f);
+    EXPECT_EQ(system.getStats().spawned, 59u);
+    EXPECT_EQ(system.getStats().dropped, 41u);
+    EXPECT_EQ(emitter.burst, 0);
+    EXPECT_EQ(system.getPool().size(), 64u);
+}
+
+TEST(ParticlePool, ZeroLifetimeParticlesDieOnTheNextUpdate) {
+    ParticlePool pool(4);
+    pool.spawn({.lifetime = 0.0f});
+    EXPECT_EQ(pool.getLifetime()[0], 0.0f);
+    EXPECT_EQ(pool.update(0.0f), 1u);
+    EXPECT_TRUE(pool.empty());
+}
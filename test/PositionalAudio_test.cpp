@@ -0,0 +1,146 @@
+#include "gtest/gtest.h"
+#include "asteroid/PositionalAudio.hpp"
+#include "TestWav.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+using ast::AudioEmitter;
+using ast::Vector2;
+
+class PositionalAudioTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        wavPath_ = std::filesystem::temp_directory_path() / "asteroid_positional_audio_test.wav";
+        ast::test::writeToneWav(wavPath_, 48000);
+        ASSERT_TRUE(audio_.initOffline(2, 48000));
+        ASSERT_TRUE(audio_.loadSound("tone", wavPath_));
+        system_ = &registry_.attach<ast::PositionalAudioSystem>(registry_, 4);
+        registry_.emplace<ast::AudioListener>(registry_.createEntity(), LISTENER);
+    }
+
+    void TearDown() override {
+        audio_.shutdown();
+        std::filesystem::remove(wavPath_);
+    }
+
+    ast::Entity addEmitter(Vector2 position, int loops = 0) {
+        ast::Entity entity = registry_.createEntity();
+        registry_.emplace<AudioEmitter>(entity, "tone", position, loops);
+        return entity;
+    }
+
+    // Components reach systems after the update they were added in
+    void update() {
+        registry_.update(0.0f);
+        registry_.update(0.0f);
+    }
+
+    static constexpr Vector2 LISTENER{100.0f, 50.0f};
+
+    ast::Audio& audio_ = ast::Audio::getInstance();
+    ast::Registry registry_;
+    ast::PositionalAudioSystem* system_ = nullptr;
+    std::filesystem::path wavPath_;
+};
+
+TEST_F(PositionalAudioTest, GainAndPanMatchScalarReference) {
+    // Not a multiple of the SIMD width, so both paths run. Emitters play once when
+    // triggered, so none of them takes a voice here.
+    std::vector<ast::Entity> entities;
+    for (int i = 0; i < 37; ++i) {
+        ast::Entity entity = addEmitter(
+            {static_cast<float>(i * 37 % 500 - 200), static_cast<float>(i * 53 % 300 - 100)},
+            1);
+        auto* emitter = registry_.get<AudioEmitter>(entity);
+        emitter->gain = 0.5f + 0.25f * (i % 3);
+        emitter->minDistance = 16.0f * (i % 5);
+        emitter->maxDistance = emitter->minDistance + 100.0f + 20.0f * i;
+        entities.push_back(entity);
+    }
+    update();
+
+    for (ast::Entity entity : entities) {
+        const auto* emitter = registry_.get<AudioEmitter>(entity);
+        float dx = emitter->position.x - LISTENER.x;
+        float dy = emitter->position.y - LISTENER.y;
+        float distance = std::sqrt(dx * dx + dy * dy);
+        float fade = (distance - emitter->minDistance) /
+                     std::max(emitter->maxDistance - emitter->minDistance, 1e-3f);
+        float gain = std::clamp(1.0f - fade, 0.0f, 1.0f) * emitter->gain;
+        float pan = std::clamp(dx / std::max(distance, std::max(emitter->minDistance, 1.0f)),
+                               -1.0f, 1.0f);
+        EXPECT_NEAR(emitter->audibleGain, gain, 1e-5f);
+        EXPECT_NEAR(emitter->pan, pan, 1e-5f);
+    }
+    EXPECT_EQ(system_->getStats().emitters, 37u);
+    EXPECT_EQ(system_->getStats().playing, 0u);
+}
+
+TEST_F(PositionalAudioTest, CullsQuietestEmittersBeyondVoiceBudget) {
+    system_->setMaxVoices(2);
+    ast::Entity near = addEmitter({LISTENER.x + 10.0f, LISTENER.y});
+    ast::Entity middle = addEmitter({LISTENER.x - 300.0f, LISTENER.y});
+    ast::Entity far = addEmitter({LISTENER.x + 600.0f, LISTENER.y});
+    ast::Entity silent = addEmitter({LISTENER.x, LISTENER.y + 2000.0f});
+    update();
+
+    const auto& stats = system_->getStats();
+    EXPECT_EQ(stats.emitters, 4u);
+    EXPECT_EQ(stats.audible, 3u);
+    EXPECT_EQ(stats.playing, 2u);
+    EXPECT_EQ(stats.culled, 1u);
+    EXPECT_TRUE(audio_.isVoicePlaying(registry_.get<AudioEmitter>(near)->voice));
+    EXPECT_TRUE(audio_.isVoicePlaying(registry_.get<AudioEmitter>(middle)->voice));
+    EXPECT_EQ(registry_.get<AudioEmitter>(far)->voice, ast::NULL_VOICE_ID);
+    EXPECT_EQ(registry_.get<AudioEmitter>(silent)->voice, ast::NULL_VOICE_ID);
+
+    // Moving the far emitter next to the listener takes the voice of the quietest one
+    const ast::VoiceId middleVoice = registry_.get<AudioEmitter>(middle)->voice;
+    registry_.get<AudioEmitter>(far)->position = LISTENER;
+    registry_.update(0.0f);
+    EXPECT_NE(registry_.get<AudioEmitter>(far)->voice, ast::NULL_VOICE_ID);
+    EXPECT_EQ(registry_.get<AudioEmitter>(middle)->voice, ast::NULL_VOICE_ID);
+    EXPECT_FALSE(audio_.isVoicePlaying(middleVoice));
+}
+
+TEST_F(PositionalAudioTest, SoundGainAppliesOnEveryUpdate) {
+    constexpr std::size_t FRAMES = 1024;
+    std::vector<float> out(FRAMES * 2);
+    auto peak = [&] {
+        EXPECT_TRUE(audio_.render(out.data(), FRAMES));
+        float result = 0.0f;
+        for (float sample : out) {
+            result = std::max(result, std::abs(sample));
+        }
+        return result;
+    };
+
+    // The voice starts through playSound() and is then updated through updateVoices()
+    audio_.setSoundGain("tone", 0.5f);
+    ast::Entity entity = addEmitter(LISTENER);
+    update();
+    ASSERT_NE(registry_.get<AudioEmitter>(entity)->voice, ast::NULL_VOICE_ID);
+    const float startPeak = peak();
+    ASSERT_GT(startPeak, 0.0f);
+    registry_.update(0.0f);
+    EXPECT_NEAR(peak(), startPeak, 1e-3f);
+
+    audio_.setSoundGain("tone", 1.0f);
+    registry_.update(0.0f);
+    EXPECT_NEAR(peak(), 2.0f * startPeak, 1e-3f);
+}
+
+TEST_F(PositionalAudioTest, CountsOnlyVoicesThatStarted) {
+    addEmitter({LISTENER.x + 10.0f, LISTENER.y});
+    ast::Entity missing = registry_.createEntity();
+    registry_.emplace<AudioEmitter>(missing, "missing.wav", LISTENER);
+    update();
+
+    const auto& stats = system_->getStats();
+    EXPECT_EQ(stats.audible, 2u);
+    EXPECT_EQ(stats.playing, 1u);
+    EXPECT_EQ(registry_.get<AudioEmitter>(missing)->voice, ast::NULL_VOICE_ID);
+}
@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+#include "asteroid/Profiler.hpp"
+#include "asteroid/ecs/Registry.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+
+nlohmann::json exportTrace() {
+    auto path = std::filesystem::temp_directory_path() / "asteroid_profiler_test.json";
+    EXPECT_TRUE(ast::Profiler::exportChromeTrace(path));
+    std::ifstream file(path);
+    return nlohmann::json::parse(file);
+}
+
+std::size_t countZones(const nlohmann::json& trace, const std::string& name) {
+    std::size_t count = 0;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "X" && event["name"] == name) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+struct ProfiledSystem : ast::SystemBase {
+    using SystemBase::SystemBase;
+    void update(float) override {}
+};
+
+TEST(Profiler, ExportsNestedZonesPerThread) {
+    ast::Profiler::clear();
+    {
+        ast::Profiler::Zone outer("outer");
+        ast::Profiler::Zone inner("inner");
+    }
+    std::thread([] { ast::Profiler::Zone zone("worker"); }).join();
+
+    nlohmann::json trace = exportTrace();
+    EXPECT_EQ(countZones(trace, "outer"), 1u);
+    EXPECT_EQ(countZones(trace, "inner"), 1u);
+    EXPECT_EQ(countZones(trace, "worker"), 1u);
+
+    const nlohmann::json* outer = nullptr;
+    const nlohmann::json* inner = nullptr;
+    const nlohmann::json* worker = nullptr;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["name"] == "outer") {
+            outer = &event;
+        } else if (event["name"] == "inner") {
+            inner = &event;
+        } else if (event["name"] == "worker") {
+            worker = &event;
+        }
+    }
+    ASSERT_TRUE(outer && inner && worker);
+    // The inner zone lies within the outer one on the same thread
+    EXPECT_EQ((*outer)["tid"], (*inner)["tid"]);
+    EXPECT_NE((*outer)["tid"], (*worker)["tid"]);
+    EXPECT_LE((*outer)["ts"].get<double>(), (*inner)["ts"].get<double>());
+    EXPECT_GE((*outer)["dur"].get<double>(), (*inner)["dur"].get<double>());
+}
+
+TEST(Profiler, ClearAndDisable) {
+    {
+        ast::Profiler::Zone zone("before");
+    }
+    ast::Profiler::clear();
+    ast::Profiler::setEnabled(false);
+    {
+        ast::Profiler::Zone zone("disabled");
+    }
+    ast::Profiler::setEnabled(true);
+
+    nlohmann::json trace = exportTrace();
+    EXPECT_EQ(countZones(trace, "before"), 0u);
+    EXPECT_EQ(countZones(trace, "disabled"), 0u);
+}
+
+TEST(Profiler, KeepsTheMostRecentZones) {
+    ast::Profiler::clear();
+    for (std::size_t i = 0; i < ast::Profiler::EVENTS_PER_THREAD + 10; ++i) {
+        ast::Profiler::record(i < 10 ? "old" : "new", i, i + 1);
+    }
+    nlohmann::json trace = exportTrace();
+    EXPECT_EQ(countZones(trace, "old"), 0u);
+    // The oldest slot is skipped since it could be in the middle of being overwritten
+    EXPECT_EQ(countZones(trace, "new"), ast::Profiler::EVENTS_PER_THREAD - 1);
+}
+
+TEST(Profiler, DemanglesTypeNames) {
+    EXPECT_STREQ(ast::Profiler::getTypeName(typeid(ast::Profiler)), "ast::Profiler");
+}
+
+TEST(Profiler, NamesSystemZonesWhenAttached) {
+    ast::Registry registry;
+    auto& system = registry.attach<ProfiledSystem>(registry);
+    EXPECT_EQ(system.getProfileName(), ast::Profiler::getTypeName(typeid(ProfiledSystem)));
+
+#ifndef NDEBUG
+    ast::Profiler::clear();
+    registry.update(0.0f);
+    EXPECT_EQ(countZones(exportTrace(), system.getProfileName()), 1u);
+#endif
+}
+
+TEST(Profiler, ClearFreesBuffersOfExitedThreads) {
+    ast::Profiler::clear();
+    const std::size_t before = ast::Profiler::getThreadBufferCount();
+    std::thread([] { ast::Profiler::Zone zone("exited"); }).join();
+    EXPECT_EQ(ast::Profiler::getThreadBufferCount(), before + 1);
+    EXPECT_EQ(countZones(exportTrace(), "exited"), 1u);
+
+    ast::Profiler::clear();
+    EXPECT_EQ(ast::Profiler::getThreadBufferCount(), before);
+}
@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+#include "asteroid/EventBus.hpp"
+#include "asteroid/RenderLayer.hpp"
+#include "TestRenderer.hpp"
+
+class RenderLayerTest : public ast::test::RendererTest {
+protected:
+    ast::RenderLayer::DrawFunction countDraws() {
+        return [this](SDL_Renderer* renderer) {
+            ++draws_;
+            const SDL_FRect rect{8, 8, 16, 16};
+            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+            SDL_RenderFillRect(renderer, &rect);
+        };
+    }
+
+    int draws_ = 0;
+};
+
+TEST_F(RenderLayerTest, StaticLayerDrawsOnlyWhenInvalidated) {
+    ast::RenderLayer layer(countDraws(), true);
+    for (int frame = 0; frame < 5; ++frame) {
+        layer.render(renderer_);
+    }
+    EXPECT_EQ(draws_, 1);
+    EXPECT_TRUE(layer.isValid());
+
+    layer.invalidate();
+    layer.render(renderer_);
+    layer.render(renderer_);
+    EXPECT_EQ(draws_, 2);
+    EXPECT_EQ(layer.getRedrawCount(), 2u);
+}
+
+TEST_F(RenderLayerTest, DynamicLayerDrawsEveryFrame) {
+    ast::RenderLayer layer(countDraws());
+    for (int frame = 0; frame < 5; ++frame) {
+        layer.render(renderer_);
+    }
+    EXPECT_EQ(draws_, 5);
+    EXPECT_EQ(layer.getRedrawCount(), 0u);
+}
+
+TEST_F(RenderLayerTest, LostRenderTargetsInvalidateTheCache) {
+    ast::RenderLayer layer(countDraws(), true);
+    layer.render(renderer_);
+    ast::EventBus::publish(ast::events::RenderTargetsResetEvent{});
+    EXPECT_FALSE(layer.isValid());
+    layer.render(renderer_);
+    EXPECT_EQ(draws_, 2);
+}
@@ -0,0 +1,61 @@
+#include "gtest/gtest.h"
+#include "asteroid/JobSystem.hpp"
+#include "asteroid/RenderQueue.hpp"
+
+#include <algorithm>
+#include <random>
+
+using ast::RenderQueue;
+
+TEST(RenderQueue, KeysOrderByLayerThenTextureThenDepth) {
+    EXPECT_LT(RenderQueue::makeKey(-1, 9, 9.0f), RenderQueue::makeKey(0, 0, 0.0f));
+    EXPECT_LT(RenderQueue::makeKey(0, 9, 9.0f), RenderQueue::makeKey(1, 0, -9.0f));
+    EXPECT_LT(RenderQueue::makeKey(1, 1, 9.0f), RenderQueue::makeKey(1, 2, -9.0f));
+    EXPECT_LT(RenderQueue::makeKey(1, 1, -2.0f), RenderQueue::makeKey(1, 1, -1.0f));
+    EXPECT_LT(RenderQueue::makeKey(1, 1, -1.0f), RenderQueue::makeKey(1, 1, 0.5f));
+    EXPECT_LT(RenderQueue::makeKey(1, 1, 0.5f), RenderQueue::makeKey(1, 1, 100.0f));
+}
+
+TEST(RenderQueue, SortsLikeAStableSort) {
+    RenderQueue queue;
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> layers(-3, 3);
+    std::uniform_int_distribution<ast::TextureId> textures(1, 5);
+    std::uniform_real_distribution<float> depths(-10.0f, 10.0f);
+    std::vector<ast::RenderCommand> expected;
+    for (int i = 0; i < 5000; ++i) {
+        queue.getBuffer().draw(textures(random), {static_cast<float>(i), 0, 1, 1},
+                               layers(random), depths(random));
+    }
+    for (const ast::RenderCommand* command : queue.sort()) {
+        expected.push_back(*command);
+    }
+    ASSERT_EQ(expected.size(), 5000u);
+    EXPECT_TRUE(std::is_sorted(expected.begin(), expected.end(),
+                               [](const auto& lhs, const auto& rhs) { return lhs.key < rhs.key; }));
+    // Equal keys keep their recording order
+    for (std::size_t i = 1; i < expected.size(); ++i) {
+        if (expected[i - 1].key == expected[i].key) {
+            EXPECT_LT(expected[i - 1].destination.x, expected[i].destination.x);
+        }
+    }
+}
+
+TEST(RenderQueue, MergesBuffersRecordedOnManyThreads) {
+    RenderQueue queue;
+    ast::JobSystem jobs(3);
+    jobs.parallelFor(10000, 100, [&](std::size_t begin, std::size_t end) {
+        RenderQueue::Buffer& buffer = queue.getBuffer();
+        for (std::size_t i = begin; i < end; ++i) {
+            buffer.draw(static_cast<ast::TextureId>(i % 7 + 1), {}, static_cast<int>(i % 3));
+        }
+    });
+    EXPECT_EQ(queue.size(), 10000u);
+    const auto& sorted = queue.sort();
+    ASSERT_EQ(sorted.size(), 10000u);
+    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(),
+                               [](auto* lhs, auto* rhs) { return lhs->key < rhs->key; }));
+    queue.clear();
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_TRUE(queue.sort().empty());
+}
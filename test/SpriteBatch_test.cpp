@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+#include "asteroid/SpriteBatch.hpp"
+#include "TestRenderer.hpp"
+
+class SpriteBatchTest : public ast::test::RendererTest {
+protected:
+    void SetUp() override {
+        ASSERT_NO_FATAL_FAILURE(RendererTest::SetUp());
+        for (SDL_Texture*& texture : textures_) {
+            texture = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32,
+                                        SDL_TEXTUREACCESS_STATIC, 8, 8);
+        }
+        batch_.setRenderer(renderer_);
+    }
+
+    void TearDown() override {
+        for (SDL_Texture* texture : textures_) {
+            SDL_DestroyTexture(texture);
+        }
+        RendererTest::TearDown();
+    }
+
+    SDL_Texture* textures_[3] = {};
+    ast::SpriteBatch batch_;
+};
+
+TEST_F(SpriteBatchTest, DrawsEachTextureInOneCall) {
+    for (int i = 0; i < 300; ++i) {
+        batch_.draw(textures_[i % 3], {0, 0, 8, 8}, {float(i % 64), 0, 8, 8});
+    }
+    batch_.flush();
+    EXPECT_EQ(batch_.getStats().sprites, 300u);
+    EXPECT_EQ(batch_.getStats().drawCalls, 3u);
+    EXPECT_TRUE(batch_.empty());
+}
+
+TEST_F(SpriteBatchTest, SplitsRunsAtLayers) {
+    batch_.draw(textures_[0], {0, 0, 8, 8}, {0, 0, 8, 8}, 0.0f, ast::Color::WHITE, 2);
+    batch_.draw(textures_[0], {0, 0, 8, 8}, {0, 0, 8, 8}, 0.0f, ast::Color::WHITE, 0);
+    batch_.draw(textures_[1], {0, 0, 8, 8}, {0, 0, 8, 8}, 0.0f, ast::Color::WHITE, 1);
+    batch_.flush();
+    EXPECT_EQ(batch_.getStats().drawCalls, 3u);
+}
+
+TEST_F(SpriteBatchTest, ReusesBuffersAcrossFrames) {
+    for (int frame = 0; frame < 3; ++frame) {
+        for (int i = 0; i < 10; ++i) {
+            batch_.draw(nullptr, {}, {0, 0, 4, 4}, 45.0f, ast::Color::RED);
+        }
+        batch_.flush();
+        EXPECT_EQ(batch_.getStats().sprites, 10u);
+        EXPECT_EQ(batch_.getStats().drawCalls, 1u);
+    }
+}
+
+TEST_F(SpriteBatchTest, FlushingAnEmptyBatchDrawsNothing) {
+    batch_.flush();
+    EXPECT_EQ(batch_.getStats().drawCalls, 0u);
+}
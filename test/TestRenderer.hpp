@@ -0,0 +1,40 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <SDL3/SDL.h>
+
+namespace ast::test {
+
+/**
+ * Fixture drawing with a software renderer into a SIZE x SIZE RGBA surface.
+ * Fixtures deriving from it call ASSERT_NO_FATAL_FAILURE(RendererTest::SetUp()) first in
+ * their SetUp() and RendererTest::TearDown() last in their TearDown().
+ */
+class RendererTest : public ::testing::Test {
+protected:
+    static constexpr int SIZE = 64;
+
+    void SetUp() override {
+        surface_ = SDL_CreateSurface(SIZE, SIZE, SDL_PIXELFORMAT_RGBA32);
+        ASSERT_NE(surface_, nullptr);
+        renderer_ = SDL_CreateSoftwareRenderer(surface_);
+        ASSERT_NE(renderer_, nullptr);
+    }
+
+    void TearDown() override {
+        if (renderer_) {
+            SDL_DestroyRenderer(renderer_);
+            renderer_ = nullptr;
+        }
+        if (surface_) {
+            SDL_DestroySurface(surface_);
+            surface_ = nullptr;
+        }
+    }
+
+    SDL_Surface* surface_ = nullptr;
+    SDL_Renderer* renderer_ = nullptr;
+};
+
+}  // namespace ast::test
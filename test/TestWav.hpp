@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace ast::test {
+
+/**
+ * Write one second of a mono 16-bit sine tone as a WAV file.
+ * @param path The file to write
+ * @param sampleRate The sample rate in Hz
+ */
+inline void writeToneWav(const std::filesystem::path& path, std::uint32_t sampleRate) {
+    std::vector<std::int16_t> pcm(sampleRate);
+    for (std::size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<std::int16_t>(8000.0 * std::sin(i * 0.05));
+    }
+    std::ofstream file(path, std::ios::binary);
+    auto write32 = [&file](std::uint32_t value) {
+        file.write(reinterpret_cast<const char*>(&value), 4);
+    };
+    auto write16 = [&file](std::uint16_t value) {
+        file.write(reinterpret_cast<const char*>(&value), 2);
+    };
+    const auto dataSize = static_cast<std::uint32_t>(pcm.size() * sizeof(std::int16_t));
+    file.write("RIFF", 4);
+    write32(36 + dataSize);
+    file.write("WAVEfmt ", 8);
+    write32(16);
+    write16(1);  // PCM
+    write16(1);  // Mono
+    write32(sampleRate);
+    write32(sampleRate * sizeof(std::int16_t));
+    write16(sizeof(std::int16_t));
+    write16(16);
+    file.write("data", 4);
+    write32(dataSize);
+    file.write(reinterpret_cast<const char*>(pcm.data()), dataSize);
+}
+
+}  // namespace ast::test
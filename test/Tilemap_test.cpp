@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+#include "asteroid/Tilemap.hpp"
+#include "TestRenderer.hpp"
+
+using ast::Rect;
+using ast::Tilemap;
+
+class TilemapTest : public ast::test::RendererTest {
+protected:
+    void SetUp() override {
+        ASSERT_NO_FATAL_FAILURE(RendererTest::SetUp());
+        // 64x64 tiles of 8 pixels in chunks of 16x16 tiles; without a tileset the tiles
+        // are drawn as solid rectangles
+        map_.fill(1);
+    }
+
+    Tilemap map_{64, 64, ast::NULL_TEXTURE_ID, 8, 16};
+};
+
+TEST_F(TilemapTest, CullsChunksOutsideTheView) {
+    map_.draw(renderer_, Rect{0.0f, 0.0f, 128.0f, 128.0f});
+    EXPECT_EQ(map_.getStats().chunks, 16u);
+    EXPECT_EQ(map_.getStats().visibleChunks, 1u);
+    EXPECT_EQ(map_.getStats().tiles, 256u);
+
+    map_.draw(renderer_, Rect{100.0f, 100.0f, 64.0f, 64.0f});
+    EXPECT_EQ(map_.getStats().visibleChunks, 4u);
+}
+
+TEST_F(TilemapTest, RebuildsOnlyChangedChunks) {
+    const Rect everything = map_.getBounds();
+    map_.draw(renderer_, everything);
+    EXPECT_EQ(map_.getStats().rebuiltChunks, 16u);
+    map_.draw(renderer_, everything);
+    EXPECT_EQ(map_.getStats().rebuiltChunks, 0u);
+
+    map_.setTile(20, 40, Tilemap::EMPTY_TILE);
+    map_.setTile(21, 40, Tilemap::EMPTY_TILE);
+    map_.draw(renderer_, everything);
+    EXPECT_EQ(map_.getStats().rebuiltChunks, 1u);
+    EXPECT_EQ(map_.getStats().tiles, 64u * 64u - 2u);
+    EXPECT_EQ(map_.getTile(20, 40), Tilemap::EMPTY_TILE);
+    EXPECT_EQ(map_.getTile(19, 40), 1);
+}
+
+TEST_F(TilemapTest, FollowsTheCamera) {
+    map_.setPosition({1000.0f, 0.0f});
+    const ast::Camera camera({1128.0f, 128.0f}, {0.0f, 0.0f, 64.0f, 64.0f}, 2.0f);
+    map_.draw(renderer_, camera);
+    // The camera sees a 32x32 area around the corner shared by four chunks
+    EXPECT_EQ(map_.getStats().visibleChunks, 4u);
+    EXPECT_EQ(map_.getStats().tiles, 4u * 256u);
+}
+
+TEST_F(TilemapTest, HandlesPartialChunks) {
+    Tilemap map(20, 5, ast::NULL_TEXTURE_ID, 8, 16);
+    map.fill(3);
+    map.draw(renderer_, map.getBounds());
+    EXPECT_EQ(map.getStats().chunks, 2u);
+    EXPECT_EQ(map.getStats().tiles, 100u);
+    EXPECT_EQ(map.getTile(20, 0), Tilemap::EMPTY_TILE);
+}
@@ -0,0 +1,30 @@
+#include <filesystem>
+#include <iostream>
+
+#include "asteroid/AssetPack.hpp"
+
+// Usage: asset_packer <assets-dir> <output.pak>
+// The pack can then be passed to the engine in place of the assets directory.
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <assets-dir> <output.pak>\n";
+        return 1;
+    }
+    std::filesystem::path directory = argv[1];
+    std::filesystem::path output = argv[2];
+    if (!std::filesystem::is_directory(directory)) {
+        std::cerr << directory.string() << " is not a directory\n";
+        return 1;
+    }
+    if (!ast::AssetPack::write(directory, output)) {
+        std::cerr << "Failed to write " << output.string() << '\n';
+        return 1;
+    }
+    auto pack = ast::AssetPack::open(output);
+    if (!pack) {
+        std::cerr << "Failed to read back " << output.string() << '\n';
+        return 1;
+    }
+    std::cout << "Packed " << pack->getEntryCount() << " files into " << output.string() << '\n';
+    return 0;
+}